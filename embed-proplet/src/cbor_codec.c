@@ -0,0 +1,150 @@
+#include "cbor_codec.h"
+
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+
+#include <zcbor_common.h>
+#include <zcbor_encode.h>
+
+#include "task_trace.h"
+
+/* Key/value pair counts for the top-level and nested maps. zcbor only uses
+ * them to pick the map header width, so they are upper bounds.
+ */
+#define RESULT_MAP_PAIRS 3
+#define METRICS_MAP_PAIRS 8
+#define ALIVE_MAP_PAIRS 3
+
+static bool put_kv_tstr(zcbor_state_t *zs, const char *key, const char *val)
+{
+  return zcbor_tstr_put_term(zs, key, SIZE_MAX) &&
+         zcbor_tstr_put_term(zs, (val != NULL) ? val : "", SIZE_MAX);
+}
+
+static bool put_kv_float(zcbor_state_t *zs, const char *key, double val)
+{
+  return zcbor_tstr_put_term(zs, key, SIZE_MAX) && zcbor_float64_put(zs, val);
+}
+
+static bool put_kv_uint(zcbor_state_t *zs, const char *key, uint64_t val)
+{
+  return zcbor_tstr_put_term(zs, key, SIZE_MAX) && zcbor_uint64_put(zs, val);
+}
+
+int cbor_codec_encode_result(uint8_t *buf, size_t buf_size, size_t *out_len,
+                             const char *task_id, const char *results,
+                             const char *error_msg)
+{
+  zcbor_state_t zs[3];
+
+  zcbor_new_encode_state(zs, ARRAY_SIZE(zs), buf, buf_size, 0);
+
+  bool ok = zcbor_map_start_encode(zs, RESULT_MAP_PAIRS) &&
+            put_kv_tstr(zs, "task_id", task_id) &&
+            put_kv_tstr(zs, "results", results);
+  if (ok && error_msg != NULL) {
+    ok = put_kv_tstr(zs, "error", error_msg);
+  }
+  ok = ok && zcbor_map_end_encode(zs, RESULT_MAP_PAIRS);
+
+  if (!ok) {
+    return -ENOMEM;
+  }
+
+  *out_len = (size_t)(zs->payload - buf);
+  return 0;
+}
+
+int cbor_codec_encode_task_metrics(uint8_t *buf, size_t buf_size,
+                                   size_t *out_len,
+                                   const task_metrics_t *metrics,
+                                   const char *proplet_id,
+                                   int64_t timestamp_ms)
+{
+  zcbor_state_t zs[4];
+
+  zcbor_new_encode_state(zs, ARRAY_SIZE(zs), buf, buf_size, 0);
+
+  bool ok = zcbor_map_start_encode(zs, METRICS_MAP_PAIRS) &&
+            put_kv_tstr(zs, "task_id", metrics->task_id) &&
+            put_kv_tstr(zs, "proplet_id", proplet_id) &&
+            put_kv_uint(zs, "timestamp", (uint64_t)timestamp_ms);
+
+  ok = ok && zcbor_tstr_put_lit(zs, "metrics") &&
+       zcbor_map_start_encode(zs, METRICS_MAP_PAIRS) &&
+       put_kv_float(zs, "cpu_percent", metrics->current.cpu_percent) &&
+       put_kv_uint(zs, "memory_bytes", metrics->current.memory_bytes) &&
+       put_kv_float(zs, "memory_percent", metrics->current.memory_percent) &&
+       put_kv_uint(zs, "uptime_seconds",
+                   (uint64_t)metrics->current.uptime_seconds) &&
+       put_kv_uint(zs, "thread_count", metrics->current.thread_count) &&
+       zcbor_map_end_encode(zs, METRICS_MAP_PAIRS);
+
+  ok = ok && zcbor_tstr_put_lit(zs, "aggregated") &&
+       zcbor_map_start_encode(zs, METRICS_MAP_PAIRS + 1) &&
+       put_kv_float(zs, "avg_cpu_usage", metrics->aggregated.avg_cpu_usage) &&
+       put_kv_float(zs, "min_cpu_usage", metrics->aggregated.min_cpu_usage) &&
+       put_kv_float(zs, "max_cpu_usage", metrics->aggregated.max_cpu_usage) &&
+       put_kv_float(zs, "p95_cpu_usage", metrics->aggregated.p95_cpu_usage) &&
+       put_kv_uint(zs, "avg_memory_usage",
+                   metrics->aggregated.avg_memory_usage) &&
+       put_kv_uint(zs, "min_memory_usage",
+                   metrics->aggregated.min_memory_usage) &&
+       put_kv_uint(zs, "max_memory_usage",
+                   metrics->aggregated.max_memory_usage) &&
+       put_kv_uint(zs, "p95_memory_usage",
+                   metrics->aggregated.p95_memory_usage) &&
+       put_kv_uint(zs, "sample_count",
+                   (uint64_t)metrics->aggregated.sample_count) &&
+       zcbor_map_end_encode(zs, METRICS_MAP_PAIRS + 1);
+
+#if defined(CONFIG_PROPLET_STAGE_TRACING)
+  uint64_t stage_cycles[TASK_TRACE_STAGE_COUNT];
+
+  if (ok && task_trace_get(metrics->task_id, stage_cycles) == 0) {
+    ok = zcbor_tstr_put_lit(zs, "stages") &&
+         zcbor_map_start_encode(zs, TASK_TRACE_STAGE_COUNT);
+    for (int i = 0; ok && i < TASK_TRACE_STAGE_COUNT; i++) {
+      ok = put_kv_uint(zs, task_trace_stage_name(i),
+                       k_cyc_to_us_floor64(stage_cycles[i]));
+    }
+    ok = ok && zcbor_map_end_encode(zs, TASK_TRACE_STAGE_COUNT);
+  }
+#endif
+
+  ok = ok && zcbor_map_end_encode(zs, METRICS_MAP_PAIRS);
+
+  if (!ok) {
+    return -ENOMEM;
+  }
+
+  *out_len = (size_t)(zs->payload - buf);
+  return 0;
+}
+
+int cbor_codec_encode_alive(uint8_t *buf, size_t buf_size, size_t *out_len,
+                            const char *proplet_id, const char *namespace_id)
+{
+  zcbor_state_t zs[3];
+
+  zcbor_new_encode_state(zs, ARRAY_SIZE(zs), buf, buf_size, 0);
+
+  bool ok = zcbor_map_start_encode(zs, ALIVE_MAP_PAIRS) &&
+            put_kv_tstr(zs, "status", "alive") &&
+            put_kv_tstr(zs, "proplet_id", proplet_id) &&
+            put_kv_tstr(zs, "namespace", namespace_id) &&
+            zcbor_map_end_encode(zs, ALIVE_MAP_PAIRS);
+
+  if (!ok) {
+    return -ENOMEM;
+  }
+
+  *out_len = (size_t)(zs->payload - buf);
+  return 0;
+}
+
+#endif /* CONFIG_PROPLET_CBOR_ENCODING */
@@ -0,0 +1,60 @@
+#ifndef CBOR_CODEC_H
+#define CBOR_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "task_monitor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+
+/**
+ * @brief Encode a task result payload as a CBOR map.
+ *
+ * Mirrors the JSON result schema: task_id, results and (optionally) error.
+ *
+ * @param buf Destination buffer for the encoded payload.
+ * @param buf_size Size of the destination buffer.
+ * @param out_len Receives the encoded length on success.
+ * @param task_id Task identifier.
+ * @param results Raw results string (may be NULL).
+ * @param error_msg Error message, or NULL for a successful result.
+ * @return 0 on success, negative errno on encoding failure.
+ */
+int cbor_codec_encode_result(uint8_t *buf, size_t buf_size, size_t *out_len,
+                             const char *task_id, const char *results,
+                             const char *error_msg);
+
+/**
+ * @brief Encode per-task metrics as a CBOR map.
+ *
+ * Mirrors the JSON task metrics schema including the current and
+ * aggregated sub-maps (and stage latencies when tracing is enabled).
+ *
+ * @return 0 on success, negative errno on encoding failure.
+ */
+int cbor_codec_encode_task_metrics(uint8_t *buf, size_t buf_size,
+                                   size_t *out_len,
+                                   const task_metrics_t *metrics,
+                                   const char *proplet_id,
+                                   int64_t timestamp_ms);
+
+/**
+ * @brief Encode the periodic alive message as a CBOR map.
+ *
+ * @return 0 on success, negative errno on encoding failure.
+ */
+int cbor_codec_encode_alive(uint8_t *buf, size_t buf_size, size_t *out_len,
+                            const char *proplet_id, const char *namespace_id);
+
+#endif /* CONFIG_PROPLET_CBOR_ENCODING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBOR_CODEC_H */
@@ -0,0 +1,98 @@
+#include "discovery_cache.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+LOG_MODULE_REGISTER(discovery_cache);
+
+/* The rendered discovery payload is stored under "discovery/..." in the
+ * settings backend next to the registry cache, keyed by a CRC over the
+ * inputs it was rendered from. Warm boots with unchanged hardware facts
+ * reuse it instead of rebuilding the document.
+ */
+#define DISCOVERY_MAX_PAYLOAD 1024
+
+struct discovery_load_ctx {
+  char *buf;
+  size_t buf_size;
+  uint32_t crc;
+  bool crc_ok;
+  bool payload_ok;
+};
+
+static int discovery_load_cb(const char *key, size_t len,
+                             settings_read_cb read_cb, void *cb_arg,
+                             void *param) {
+  struct discovery_load_ctx *ctx = param;
+
+  if (strcmp(key, "crc") == 0) {
+    if (len == sizeof(ctx->crc) &&
+        read_cb(cb_arg, &ctx->crc, sizeof(ctx->crc)) ==
+            (ssize_t)sizeof(ctx->crc)) {
+      ctx->crc_ok = true;
+    }
+    return 0;
+  }
+
+  if (strcmp(key, "payload") == 0) {
+    if (len >= ctx->buf_size) {
+      return 0;
+    }
+    ssize_t rc = read_cb(cb_arg, ctx->buf, len);
+    if (rc >= 0) {
+      ctx->buf[rc] = '\0';
+      ctx->payload_ok = true;
+    }
+  }
+
+  return 0;
+}
+
+int discovery_cache_get(uint32_t inputs_crc, char *buf, size_t buf_size) {
+  if (buf == NULL || buf_size == 0) {
+    return -EINVAL;
+  }
+
+  struct discovery_load_ctx ctx = {
+      .buf = buf,
+      .buf_size = buf_size,
+  };
+
+  int rc = settings_load_subtree_direct("discovery", discovery_load_cb, &ctx);
+  if (rc != 0) {
+    LOG_WRN("Failed to load discovery cache: %d", rc);
+    return rc;
+  }
+
+  if (!ctx.crc_ok || !ctx.payload_ok || ctx.crc != inputs_crc) {
+    return -ENOENT;
+  }
+
+  return 0;
+}
+
+int discovery_cache_put(uint32_t inputs_crc, const char *payload) {
+  if (payload == NULL) {
+    return -EINVAL;
+  }
+
+  size_t len = strlen(payload);
+  if (len >= DISCOVERY_MAX_PAYLOAD) {
+    return -EMSGSIZE;
+  }
+
+  int rc = settings_save_one("discovery/payload", payload, len);
+  if (rc != 0) {
+    LOG_WRN("Failed to persist discovery payload: %d", rc);
+    return rc;
+  }
+
+  rc = settings_save_one("discovery/crc", &inputs_crc, sizeof(inputs_crc));
+  if (rc != 0) {
+    LOG_WRN("Failed to persist discovery CRC: %d", rc);
+  }
+  return rc;
+}
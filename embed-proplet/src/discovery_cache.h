@@ -0,0 +1,38 @@
+#ifndef DISCOVERY_CACHE_H
+#define DISCOVERY_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Load the discovery payload rendered on a previous boot.
+ *
+ * Succeeds only when the stored payload was rendered from the same
+ * inputs (identified by inputs_crc), so stale hardware facts are never
+ * republished.
+ *
+ * @param inputs_crc CRC over the discovery inputs for this boot.
+ * @param buf Destination buffer for the payload.
+ * @param buf_size Size of the destination buffer.
+ * @return 0 on success, -ENOENT when no matching payload is cached.
+ */
+int discovery_cache_get(uint32_t inputs_crc, char *buf, size_t buf_size);
+
+/**
+ * @brief Persist a freshly rendered discovery payload.
+ *
+ * @param inputs_crc CRC over the discovery inputs it was rendered from.
+ * @param payload NUL-terminated rendered payload.
+ * @return 0 on success, negative errno on failure.
+ */
+int discovery_cache_put(uint32_t inputs_crc, const char *payload);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISCOVERY_CACHE_H */
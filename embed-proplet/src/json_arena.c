@@ -0,0 +1,99 @@
+#include "json_arena.h"
+#include "cJSON.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(json_arena);
+
+/* Every allocation is prefixed with an 8-byte header tagging its origin, so
+ * the free hook can tell arena blocks from heap-fallback blocks while
+ * keeping the returned pointer 8-byte aligned for cJSON's doubles.
+ */
+#define ARENA_BLOCK_MAGIC 0x4A41524EU /* "JARN" */
+#define HEAP_BLOCK_MAGIC 0x4A484550U  /* "JHEP" */
+
+struct alloc_header {
+  uint32_t magic;
+  uint32_t reserved;
+};
+
+#define ALIGN_UP_8(n) (((n) + 7U) & ~(size_t)7U)
+
+static uint8_t g_arena[CONFIG_PROPLET_JSON_ARENA_SIZE] __aligned(8);
+static size_t g_arena_offset;
+static size_t g_arena_peak;
+static int g_live_allocs;
+static K_MUTEX_DEFINE(g_arena_mutex);
+
+static void *arena_malloc(size_t size) {
+  size_t need = ALIGN_UP_8(sizeof(struct alloc_header) + size);
+  struct alloc_header *hdr = NULL;
+
+  k_mutex_lock(&g_arena_mutex, K_FOREVER);
+  if (g_arena_offset + need <= sizeof(g_arena)) {
+    hdr = (struct alloc_header *)&g_arena[g_arena_offset];
+    g_arena_offset += need;
+    if (g_arena_offset > g_arena_peak) {
+      g_arena_peak = g_arena_offset;
+    }
+    g_live_allocs++;
+    hdr->magic = ARENA_BLOCK_MAGIC;
+  }
+  k_mutex_unlock(&g_arena_mutex);
+
+  if (hdr == NULL) {
+    /* Oversized or arena exhausted: fall back to the system heap */
+    hdr = malloc(sizeof(struct alloc_header) + size);
+    if (hdr == NULL) {
+      return NULL;
+    }
+    hdr->magic = HEAP_BLOCK_MAGIC;
+  }
+
+  return hdr + 1;
+}
+
+static void arena_free(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  struct alloc_header *hdr = (struct alloc_header *)ptr - 1;
+
+  if (hdr->magic == HEAP_BLOCK_MAGIC) {
+    free(hdr);
+    return;
+  }
+
+  k_mutex_lock(&g_arena_mutex, K_FOREVER);
+  if (--g_live_allocs == 0) {
+    /* Last node released: reclaim the whole arena at once */
+    g_arena_offset = 0;
+  }
+  k_mutex_unlock(&g_arena_mutex);
+}
+
+void json_arena_init(void) {
+  cJSON_Hooks hooks = {
+      .malloc_fn = arena_malloc,
+      .free_fn = arena_free,
+  };
+
+  cJSON_InitHooks(&hooks);
+  LOG_INF("cJSON backed by %zu byte arena", sizeof(g_arena));
+}
+
+void json_arena_get_stats(size_t *used_bytes, size_t *peak_bytes) {
+  k_mutex_lock(&g_arena_mutex, K_FOREVER);
+  if (used_bytes != NULL) {
+    *used_bytes = g_arena_offset;
+  }
+  if (peak_bytes != NULL) {
+    *peak_bytes = g_arena_peak;
+  }
+  k_mutex_unlock(&g_arena_mutex);
+}
@@ -0,0 +1,35 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Route all cJSON allocations through a resettable bump arena.
+ *
+ * Installs cJSON_InitHooks() pointing at a static arena sized by
+ * CONFIG_PROPLET_JSON_ARENA_SIZE. Nodes are bump-allocated; freeing is a
+ * counter decrement, and once the last live allocation is released the
+ * arena resets in O(1) instead of returning nodes to the system heap one
+ * by one. Allocations that do not fit fall back to the heap transparently.
+ *
+ * Call once at startup, before any cJSON use.
+ */
+void json_arena_init(void);
+
+/**
+ * @brief Report arena usage.
+ *
+ * @param used_bytes Bytes currently allocated from the arena (may be NULL).
+ * @param peak_bytes High-water mark of arena usage in bytes (may be NULL).
+ */
+void json_arena_get_stats(size_t *used_bytes, size_t *peak_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_ARENA_H */
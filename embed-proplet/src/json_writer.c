@@ -0,0 +1,147 @@
+#include "json_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Reserve one byte so the output is always NUL-terminated */
+static void jw_putc(struct json_writer *w, char c) {
+  if (w->overflow || w->len + 1 >= w->size) {
+    w->overflow = true;
+    return;
+  }
+  w->buf[w->len++] = c;
+  w->buf[w->len] = '\0';
+}
+
+static void jw_puts(struct json_writer *w, const char *s) {
+  while (*s != '\0' && !w->overflow) {
+    jw_putc(w, *s++);
+  }
+}
+
+/* Escape-as-you-write: one pass over the source, no temporary buffer */
+static void jw_put_escaped(struct json_writer *w, const char *s) {
+  for (; *s != '\0' && !w->overflow; s++) {
+    switch (*s) {
+    case '"':
+      jw_puts(w, "\\\"");
+      break;
+    case '\\':
+      jw_puts(w, "\\\\");
+      break;
+    case '\b':
+      jw_puts(w, "\\b");
+      break;
+    case '\f':
+      jw_puts(w, "\\f");
+      break;
+    case '\n':
+      jw_puts(w, "\\n");
+      break;
+    case '\r':
+      jw_puts(w, "\\r");
+      break;
+    case '\t':
+      jw_puts(w, "\\t");
+      break;
+    default:
+      if ((unsigned char)*s < 0x20) {
+        char esc[8];
+        snprintf(esc, sizeof(esc), "\\u%04x", (unsigned char)*s);
+        jw_puts(w, esc);
+      } else {
+        jw_putc(w, *s);
+      }
+      break;
+    }
+  }
+}
+
+static void jw_comma(struct json_writer *w) {
+  if (w->need_comma) {
+    jw_putc(w, ',');
+  }
+  w->need_comma = false;
+}
+
+void jw_init(struct json_writer *w, char *buf, size_t size) {
+  w->buf = buf;
+  w->size = size;
+  w->len = 0;
+  w->overflow = (size == 0);
+  w->need_comma = false;
+  if (size > 0) {
+    buf[0] = '\0';
+  }
+}
+
+bool jw_ok(const struct json_writer *w) { return !w->overflow; }
+
+size_t jw_len(const struct json_writer *w) { return w->len; }
+
+void jw_object_begin(struct json_writer *w) {
+  jw_comma(w);
+  jw_putc(w, '{');
+}
+
+void jw_object_end(struct json_writer *w) {
+  jw_putc(w, '}');
+  w->need_comma = true;
+}
+
+void jw_array_begin(struct json_writer *w) {
+  jw_comma(w);
+  jw_putc(w, '[');
+}
+
+void jw_array_end(struct json_writer *w) {
+  jw_putc(w, ']');
+  w->need_comma = true;
+}
+
+void jw_key(struct json_writer *w, const char *key) {
+  jw_comma(w);
+  jw_putc(w, '"');
+  jw_put_escaped(w, key);
+  jw_puts(w, "\":");
+}
+
+void jw_string(struct json_writer *w, const char *val) {
+  jw_comma(w);
+  jw_putc(w, '"');
+  jw_put_escaped(w, (val != NULL) ? val : "");
+  jw_putc(w, '"');
+  w->need_comma = true;
+}
+
+void jw_raw(struct json_writer *w, const char *json) {
+  jw_comma(w);
+  jw_puts(w, json);
+  w->need_comma = true;
+}
+
+void jw_number(struct json_writer *w, double val) {
+  char num[32];
+
+  /* Match cJSON: integral values print without a fraction */
+  if (val == (double)(int64_t)val) {
+    snprintf(num, sizeof(num), "%lld", (long long)val);
+  } else {
+    snprintf(num, sizeof(num), "%g", val);
+  }
+  jw_raw(w, num);
+}
+
+void jw_uint(struct json_writer *w, uint64_t val) {
+  char num[24];
+
+  snprintf(num, sizeof(num), "%llu", (unsigned long long)val);
+  jw_raw(w, num);
+}
+
+void jw_int(struct json_writer *w, int64_t val) {
+  char num[24];
+
+  snprintf(num, sizeof(num), "%lld", (long long)val);
+  jw_raw(w, num);
+}
@@ -0,0 +1,100 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Incremental JSON writer: a buffer plus cursor that appends tokens in a
+ * single pass, escaping string values as they are written. Replaces the
+ * strncat/strlen payload assembly, which was O(n^2) in payload size.
+ *
+ * All append calls are overflow-aware: once the buffer is full the writer
+ * latches an overflow flag, further appends become no-ops and jw_ok()
+ * reports failure, so callers check once at the end instead of after
+ * every append.
+ */
+struct json_writer {
+  char *buf;
+  size_t size;
+  size_t len;
+  bool overflow;
+  bool need_comma;
+};
+
+/**
+ * @brief Bind the writer to a destination buffer.
+ */
+void jw_init(struct json_writer *w, char *buf, size_t size);
+
+/**
+ * @brief True if everything appended so far fit in the buffer.
+ */
+bool jw_ok(const struct json_writer *w);
+
+/**
+ * @brief Length of the NUL-terminated output written so far.
+ */
+size_t jw_len(const struct json_writer *w);
+
+void jw_object_begin(struct json_writer *w);
+void jw_object_end(struct json_writer *w);
+void jw_array_begin(struct json_writer *w);
+void jw_array_end(struct json_writer *w);
+
+/**
+ * @brief Append an object key (escaped) followed by ':'.
+ */
+void jw_key(struct json_writer *w, const char *key);
+
+/**
+ * @brief Append a string value, escaping as it is written.
+ *
+ * NULL is written as the empty string.
+ */
+void jw_string(struct json_writer *w, const char *val);
+
+/**
+ * @brief Append pre-serialized JSON verbatim (no escaping).
+ */
+void jw_raw(struct json_writer *w, const char *json);
+
+void jw_number(struct json_writer *w, double val);
+void jw_uint(struct json_writer *w, uint64_t val);
+void jw_int(struct json_writer *w, int64_t val);
+
+/* Key/value shorthands for the fixed topic schemas */
+static inline void jw_kv_string(struct json_writer *w, const char *key,
+                                const char *val) {
+  jw_key(w, key);
+  jw_string(w, val);
+}
+
+static inline void jw_kv_number(struct json_writer *w, const char *key,
+                                double val) {
+  jw_key(w, key);
+  jw_number(w, val);
+}
+
+static inline void jw_kv_uint(struct json_writer *w, const char *key,
+                              uint64_t val) {
+  jw_key(w, key);
+  jw_uint(w, val);
+}
+
+static inline void jw_kv_raw(struct json_writer *w, const char *key,
+                             const char *json) {
+  jw_key(w, key);
+  jw_raw(w, json);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_WRITER_H */
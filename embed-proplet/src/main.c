@@ -1,5 +1,7 @@
 #include "credentials.h"
+#include "json_arena.h"
 #include "mqtt_client.h"
+#include "registry_cache.h"
 #include "task_monitor.h"
 #include "wifi_manager.h"
 #include <zephyr/kernel.h>
@@ -44,6 +46,8 @@ int main(void)
 {
 	LOG_INF("Starting Proplet...");
 
+	json_arena_init();
+
 	struct proplet_credentials creds;
 
 	if (credentials_load(&creds, &defaults) != 0) {
@@ -58,6 +62,10 @@ int main(void)
 		LOG_WRN("Task monitor init failed, metrics may be unavailable");
 	}
 
+	if (registry_cache_init() != 0) {
+		LOG_WRN("Registry cache init failed, images will be re-fetched");
+	}
+
 	if (mqtt_client_connect(creds.domain_id, creds.proplet_id,
 				creds.client_key, creds.channel_id) != 0) {
 		LOG_ERR("MQTT connect failed");
@@ -77,9 +85,13 @@ int main(void)
 		return -1;
 	}
 
-	for (int i = 0; i < 20; i++) {
-		mqtt_client_process();
-		k_sleep(K_MSEC(100));
+	/* Event-based readiness: returns as soon as subscriptions are acked
+	 * and the discovery publish is flushed, instead of a fixed settle loop.
+	 */
+	if (mqtt_client_wait_ready(2000) != 0) {
+		LOG_WRN("Broker readiness timed out, continuing anyway");
+	} else {
+		LOG_INF("Proplet ready after %lld ms", k_uptime_get());
 	}
 
 	int64_t next_alive = k_uptime_get() + PROPLET_LIVELINESS_INTERVAL_MS;
@@ -87,9 +99,26 @@ int main(void)
 	int64_t next_task_metrics = k_uptime_get() + PROPLET_TASK_METRICS_INTERVAL_MS;
 
 	while (1) {
-		mqtt_client_process();
-
+		/* Sleep on the socket until data arrives or the earliest
+		 * deadline expires, instead of polling every 200 ms.
+		 */
 		int64_t now = k_uptime_get();
+		int64_t next_deadline = next_alive;
+
+		if (next_metrics < next_deadline) {
+			next_deadline = next_metrics;
+		}
+		if (next_task_metrics < next_deadline) {
+			next_deadline = next_task_metrics;
+		}
+
+		int timeout_ms = (next_deadline > now)
+					 ? (int)(next_deadline - now)
+					 : 0;
+
+		mqtt_client_process_timeout(timeout_ms);
+
+		now = k_uptime_get();
 
 		if (now >= next_alive) {
 			publish_alive_message(creds.domain_id, creds.channel_id);
@@ -108,7 +137,5 @@ int main(void)
 						    creds.proplet_id);
 			next_task_metrics = now + PROPLET_TASK_METRICS_INTERVAL_MS;
 		}
-
-		k_sleep(K_MSEC(200));
 	}
 }
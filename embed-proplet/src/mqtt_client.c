@@ -1,8 +1,15 @@
 #include "mqtt_client.h"
 #include "cJSON.h"
+#include "cbor_codec.h"
 #include "credentials.h"
+#include "discovery_cache.h"
+#include "json_writer.h"
 #include "net/mqtt.h"
+#include "registry_cache.h"
 #include "task_monitor.h"
+#include "task_parser.h"
+#include "task_trace.h"
+#include "wasm_executor.h"
 #include "wasm_handler.h"
 
 #include <errno.h>
@@ -12,8 +19,10 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/posix/sys/eventfd.h>
 #include <zephyr/random/random.h>
 #include <zephyr/sys/base64.h>
+#include <zephyr/sys/crc.h>
 #include <zephyr/sys/util.h>
 
 #if defined(CONFIG_CPU_LOAD)
@@ -39,10 +48,19 @@ LOG_MODULE_REGISTER(mqtt_client);
 #define RX_BUFFER_SIZE 1024
 #define TX_BUFFER_SIZE 1024
 
-#if defined(PAYLOAD_BUFFER_SIZE) && (PAYLOAD_BUFFER_SIZE < 1024)
-#undef PAYLOAD_BUFFER_SIZE
-#define PAYLOAD_BUFFER_SIZE 1024
-#endif
+/* Inbound publish payloads are read straight into this arena and handed to
+ * the topic handlers by pointer+length, so large task definitions and
+ * registry responses are neither truncated nor copied an extra time. MQTT
+ * events are delivered from a single thread, so one arena suffices.
+ */
+static char g_rx_payload[CONFIG_PROPLET_RX_PAYLOAD_SIZE];
+
+/* Raw model/dataset bytes for the current FL/FML task. Transported in
+ * binary (no base64 round trip) and referenced from g_current_task by
+ * pointer+length.
+ */
+static uint8_t g_model_buf[CONFIG_PROPLET_HOST_DATA_BUF_SIZE];
+static uint8_t g_dataset_buf[CONFIG_PROPLET_HOST_DATA_BUF_SIZE];
 
 /* Default CA certificate for TLS (PEM format).
  * Set this via Kconfig or provide a custom certificate at compile time.
@@ -97,16 +115,60 @@ static char g_will_message_str[256];
 static struct mqtt_utf8 g_will_message;
 static struct mqtt_topic g_will_topic;
 
-static struct zsock_pollfd fds[1];
+/* Slot 0 is the MQTT socket; slot 1 is an eventfd the publish queue
+ * signals on enqueue, so a result produced mid-poll wakes the processing
+ * loop instead of waiting out the keepalive timeout.
+ */
+static struct zsock_pollfd fds[2];
 static int nfds;
+static int g_publish_event_fd = -1;
 
 bool mqtt_connected = false;
 
+/* Set from the CONNACK session-present flag: the broker kept this client's
+ * session (and subscriptions) from a previous connection.
+ */
+static bool g_session_present;
+
+/* True once the broker has acknowledged our subscriptions (or restored
+ * them with the session); gates mqtt_client_wait_ready().
+ */
+static bool g_subscription_ready;
+
 struct registry_response {
   char app_name[64];
   char data[MAX_BASE64_LEN];
 };
 
+/* Upper bound for a reassembled WASM image delivered in chunks */
+#define WASM_IMAGE_MAX_SIZE (64 * 1024)
+
+/* Reassembly state for a chunked registry transfer. Segments arrive in
+ * order ({app_name, chunk_idx, total_chunks, data, [crc32]}), each one
+ * base64-decoded straight into the destination buffer, so peak RAM stays
+ * flat regardless of module size. The destination is a static buffer: a
+ * 64 KB allocation can never be satisfied from the system heap pool, and
+ * only one transfer is ever in flight.
+ */
+static uint8_t g_chunk_image_buf[WASM_IMAGE_MAX_SIZE];
+
+struct chunked_transfer {
+  bool active;
+  char app_name[64];
+  int total_chunks;
+  int next_idx;
+  size_t received_len;
+  uint32_t expected_crc;
+  bool has_crc;
+  uint8_t *buffer;
+};
+
+static struct chunked_transfer g_chunked_transfer;
+
+static void chunked_transfer_reset(void) {
+  memset(&g_chunked_transfer, 0, sizeof(g_chunked_transfer));
+}
+
 static void prepare_fds(struct mqtt_client *client) {
   if (client->transport.type == MQTT_TRANSPORT_NON_SECURE) {
     fds[0].fd = client->transport.tcp.sock;
@@ -120,15 +182,33 @@ static void prepare_fds(struct mqtt_client *client) {
   nfds = 1;
 }
 
+/* Adds the publish-queue eventfd to the poll set (creating it on first
+ * use), so enqueues from other threads can interrupt a blocked poll.
+ */
+static void prepare_notify_fd(void) {
+  if (g_publish_event_fd < 0) {
+    g_publish_event_fd = eventfd(0, EFD_NONBLOCK);
+  }
+  if (g_publish_event_fd >= 0) {
+    fds[1].fd = g_publish_event_fd;
+    fds[1].events = ZSOCK_POLLIN;
+    nfds = 2;
+  }
+}
+
 static void clear_fds(void) { nfds = 0; }
 
 /* Forward declarations */
-static int http_get_json(const char *url, char *response_buffer,
-                         size_t buffer_size);
+static int http_get(const char *url, uint8_t *response_buffer,
+                    size_t buffer_size, size_t *received_len);
 static int extract_model_version_from_uri(const char *uri);
 
-static int poll_mqtt_socket(struct mqtt_client *client, int timeout) {
+static int poll_mqtt_socket(struct mqtt_client *client, int timeout,
+                            bool with_notify) {
   prepare_fds(client);
+  if (with_notify) {
+    prepare_notify_fd();
+  }
   if (nfds <= 0) {
     return -EINVAL;
   }
@@ -148,7 +228,9 @@ static void mqtt_event_handler(struct mqtt_client *client,
       LOG_ERR("MQTT connection failed [%d]", evt->result);
     } else {
       mqtt_connected = true;
-      LOG_INF("MQTT connection accepted by broker");
+      g_session_present = (evt->param.connack.session_present_flag != 0);
+      LOG_INF("MQTT connection accepted by broker (session %s)",
+              g_session_present ? "resumed" : "new");
     }
     break;
 
@@ -160,7 +242,8 @@ static void mqtt_event_handler(struct mqtt_client *client,
 
   case MQTT_EVT_PUBLISH: {
     const struct mqtt_publish_param *pub = &evt->param.publish;
-    char payload[PAYLOAD_BUFFER_SIZE];
+    char *payload = g_rx_payload;
+    size_t payload_len = pub->message.payload.len;
     int ret;
 
     extern const char *channel_id;
@@ -180,15 +263,36 @@ static void mqtt_event_handler(struct mqtt_client *client,
     LOG_INF("Message received on topic: %.*s", pub->message.topic.topic.size,
             pub->message.topic.topic.utf8);
 
-    ret = mqtt_read_publish_payload(
-        &client_ctx, payload,
-        MIN(pub->message.payload.len, PAYLOAD_BUFFER_SIZE - 1));
-    if (ret < 0) {
-      LOG_ERR("Failed to read payload [%d]", ret);
+    if (payload_len > sizeof(g_rx_payload) - 1) {
+      LOG_ERR("Payload of %zu bytes exceeds receive arena (%zu); discarding",
+              payload_len, sizeof(g_rx_payload) - 1);
+      /* Drain the payload to keep the MQTT stream in sync */
+      size_t remaining = payload_len;
+      while (remaining > 0) {
+        ret = mqtt_read_publish_payload(
+            &client_ctx, g_rx_payload,
+            MIN(remaining, sizeof(g_rx_payload)));
+        if (ret <= 0) {
+          break;
+        }
+        remaining -= ret;
+      }
       return;
     }
-    payload[ret] = '\0'; /* Null-terminate */
-    LOG_INF("Payload: %s", payload);
+
+    size_t received = 0;
+    while (received < payload_len) {
+      ret = mqtt_read_publish_payload(&client_ctx, payload + received,
+                                      payload_len - received);
+      if (ret <= 0) {
+        /* 0 means no more payload data; looping on it would spin forever */
+        LOG_ERR("Failed to read payload [%d]", ret);
+        return;
+      }
+      received += ret;
+    }
+    payload[payload_len] = '\0'; /* Null-terminate */
+    LOG_INF("Payload received (%zu bytes)", payload_len);
 
     const struct mqtt_utf8 *rtopic = &pub->message.topic.topic;
     char topic_str[256];
@@ -201,27 +305,27 @@ static void mqtt_event_handler(struct mqtt_client *client,
       LOG_INF("Received model from topic: %s (payload: %d bytes)", topic_str,
               (int)pub->message.payload.len);
 
-      size_t payload_size =
-          MIN(pub->message.payload.len, sizeof(g_current_task.model_data) - 1);
-      memcpy(g_current_task.model_data, payload, payload_size);
-      g_current_task.model_data[payload_size] = '\0';
+      size_t payload_size = MIN(payload_len, sizeof(g_model_buf));
+      memcpy(g_model_buf, payload, payload_size);
+      g_current_task.model_data = g_model_buf;
+      g_current_task.model_data_len = payload_size;
       g_current_task.model_data_fetched = true;
 
-      if (pub->message.payload.len > payload_size) {
-        LOG_WRN("Model data truncated from %d to %zu bytes, training may fail",
-                (int)pub->message.payload.len, payload_size);
+      if (payload_len > payload_size) {
+        LOG_WRN("Model data truncated from %zu to %zu bytes, training may fail",
+                payload_len, payload_size);
       }
       LOG_INF("Model data stored (size: %zu bytes)", payload_size);
     } else if (rtopic->size == strlen(start_topic) &&
                memcmp(rtopic->utf8, start_topic, rtopic->size) == 0) {
-      handle_start_command(payload);
+      handle_start_command(payload, payload_len);
     } else if (rtopic->size == strlen(stop_topic) &&
                memcmp(rtopic->utf8, stop_topic, rtopic->size) == 0) {
-      handle_stop_command(payload);
+      handle_stop_command(payload, payload_len);
     } else if (rtopic->size == strlen(registry_response_topic) &&
                memcmp(rtopic->utf8, registry_response_topic, rtopic->size) ==
                    0) {
-      (void)handle_registry_response(payload);
+      (void)handle_registry_response(payload, payload_len);
     } else {
       LOG_WRN("Unknown topic");
     }
@@ -229,6 +333,7 @@ static void mqtt_event_handler(struct mqtt_client *client,
   }
 
   case MQTT_EVT_SUBACK:
+    g_subscription_ready = true;
     LOG_INF("Subscribed successfully");
     break;
 
@@ -258,8 +363,10 @@ static void mqtt_event_handler(struct mqtt_client *client,
   }
 }
 
-static void prepare_publish_param(struct mqtt_publish_param *param,
-                                  const char *topic_str, const char *payload) {
+static void prepare_publish_param_raw(struct mqtt_publish_param *param,
+                                      const char *topic_str,
+                                      const uint8_t *payload,
+                                      size_t payload_len) {
   memset(param, 0, sizeof(*param));
 
   param->message.topic.topic.utf8 = topic_str;
@@ -267,21 +374,45 @@ static void prepare_publish_param(struct mqtt_publish_param *param,
   param->message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
 
   param->message.payload.data = (uint8_t *)payload;
-  param->message.payload.len = strlen(payload);
+  param->message.payload.len = payload_len;
 
   param->message_id = sys_rand32_get() & 0xFFFF;
   param->dup_flag = 0;
   param->retain_flag = 0;
 }
 
-static int publish_direct(const char *topic, const char *payload) {
+static void prepare_publish_param(struct mqtt_publish_param *param,
+                                  const char *topic_str, const char *payload) {
+  prepare_publish_param_raw(param, topic_str, (const uint8_t *)payload,
+                            strlen(payload));
+}
+
+/* Outbound publish queue: publishers enqueue and return immediately, and
+ * mqtt_client_process() drains the queue on the MQTT thread. Messages queued
+ * while the broker is unreachable are flushed after reconnect instead of
+ * being dropped, so WASM throughput is decoupled from network jitter.
+ */
+#define PUBLISH_QUEUE_DEPTH 16
+
+struct pending_publish {
+  char topic[160];
+  uint8_t *payload; /* owned by the queue; may be binary (CBOR) */
+  size_t payload_len;
+};
+
+static struct pending_publish g_publish_queue[PUBLISH_QUEUE_DEPTH];
+static int g_publish_queue_head;
+static int g_publish_queue_count;
+static K_MUTEX_DEFINE(g_publish_queue_mutex);
+
+static int publish_send_now(const char *topic, const uint8_t *payload,
+                            size_t payload_len) {
   if (!mqtt_connected) {
-    LOG_ERR("MQTT client is not connected. Publish aborted.");
     return -ENOTCONN;
   }
 
   struct mqtt_publish_param param;
-  prepare_publish_param(&param, topic, payload);
+  prepare_publish_param_raw(&param, topic, payload, payload_len);
 
   int ret = mqtt_publish(&client_ctx, &param);
   if (ret != 0) {
@@ -293,28 +424,118 @@ static int publish_direct(const char *topic, const char *payload) {
   return 0;
 }
 
-int publish(const char *domain_id, const char *channel_id,
-            const char *topic_template, const char *payload) {
-  if (!mqtt_connected) {
-    LOG_ERR("MQTT client is not connected. Cannot publish.");
-    return -ENOTCONN;
+static int publish_enqueue_raw(const char *topic, const uint8_t *payload,
+                               size_t payload_len) {
+  uint8_t *copy = malloc((payload_len > 0) ? payload_len : 1);
+
+  if (copy == NULL) {
+    LOG_ERR("No memory to queue publish for topic %s", topic);
+    return -ENOMEM;
+  }
+  memcpy(copy, payload, payload_len);
+
+  k_mutex_lock(&g_publish_queue_mutex, K_FOREVER);
+
+  if (g_publish_queue_count == PUBLISH_QUEUE_DEPTH) {
+    /* Queue full: drop the oldest message to keep the freshest data */
+    struct pending_publish *oldest = &g_publish_queue[g_publish_queue_head];
+    LOG_WRN("Publish queue full, dropping oldest message (topic %s)",
+            oldest->topic);
+    free(oldest->payload);
+    oldest->payload = NULL;
+    g_publish_queue_head = (g_publish_queue_head + 1) % PUBLISH_QUEUE_DEPTH;
+    g_publish_queue_count--;
   }
 
+  int slot =
+      (g_publish_queue_head + g_publish_queue_count) % PUBLISH_QUEUE_DEPTH;
+  strncpy(g_publish_queue[slot].topic, topic,
+          sizeof(g_publish_queue[slot].topic) - 1);
+  g_publish_queue[slot].topic[sizeof(g_publish_queue[slot].topic) - 1] = '\0';
+  g_publish_queue[slot].payload = copy;
+  g_publish_queue[slot].payload_len = payload_len;
+  g_publish_queue_count++;
+
+  k_mutex_unlock(&g_publish_queue_mutex);
+
+  /* Wake the processing loop if it is parked in zsock_poll() */
+  if (g_publish_event_fd >= 0) {
+    (void)eventfd_write(g_publish_event_fd, 1);
+  }
+  return 0;
+}
+
+static int publish_enqueue(const char *topic, const char *payload) {
+  return publish_enqueue_raw(topic, (const uint8_t *)payload, strlen(payload));
+}
+
+static void publish_queue_drain(void) {
+  while (mqtt_connected) {
+    k_mutex_lock(&g_publish_queue_mutex, K_FOREVER);
+
+    if (g_publish_queue_count == 0) {
+      k_mutex_unlock(&g_publish_queue_mutex);
+      return;
+    }
+
+    /* Dequeue before dropping the lock: once the head has advanced, a
+     * racing enqueue's drop-oldest can no longer free the payload while
+     * it is being sent.
+     */
+    struct pending_publish msg = g_publish_queue[g_publish_queue_head];
+    g_publish_queue[g_publish_queue_head].payload = NULL;
+    g_publish_queue_head = (g_publish_queue_head + 1) % PUBLISH_QUEUE_DEPTH;
+    g_publish_queue_count--;
+    k_mutex_unlock(&g_publish_queue_mutex);
+
+    if (publish_send_now(msg.topic, msg.payload, msg.payload_len) != 0) {
+      /* Broker or link trouble: put the message back at the head and
+       * retry on the next processing pass, unless the queue refilled in
+       * the meantime.
+       */
+      k_mutex_lock(&g_publish_queue_mutex, K_FOREVER);
+      if (g_publish_queue_count < PUBLISH_QUEUE_DEPTH) {
+        g_publish_queue_head = (g_publish_queue_head + PUBLISH_QUEUE_DEPTH - 1) %
+                               PUBLISH_QUEUE_DEPTH;
+        g_publish_queue[g_publish_queue_head] = msg;
+        g_publish_queue_count++;
+        k_mutex_unlock(&g_publish_queue_mutex);
+      } else {
+        k_mutex_unlock(&g_publish_queue_mutex);
+        LOG_WRN("Publish queue refilled during retry, dropping message "
+                "(topic %s)",
+                msg.topic);
+        free(msg.payload);
+      }
+      return;
+    }
+
+    free(msg.payload);
+  }
+}
+
+static int publish_direct(const char *topic, const char *payload) {
+  return publish_enqueue(topic, payload);
+}
+
+int publish(const char *domain_id, const char *channel_id,
+            const char *topic_template, const char *payload) {
   char topic[128];
   snprintf(topic, sizeof(topic), topic_template, domain_id, channel_id);
 
-  struct mqtt_publish_param param;
-  prepare_publish_param(&param, topic, payload);
+  return publish_enqueue(topic, payload);
+}
 
-  int ret = mqtt_publish(&client_ctx, &param);
-  if (ret != 0) {
-    LOG_ERR("Failed to publish to topic: %s. Error: %d", topic, ret);
-    return ret;
-  }
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+static int publish_raw(const char *domain_id, const char *channel_id,
+                       const char *topic_template, const uint8_t *payload,
+                       size_t payload_len) {
+  char topic[128];
+  snprintf(topic, sizeof(topic), topic_template, domain_id, channel_id);
 
-  LOG_INF("Published to topic: %s. Payload: %s", topic, payload);
-  return 0;
+  return publish_enqueue_raw(topic, payload, payload_len);
 }
+#endif
 
 int mqtt_client_connect(const char *domain_id, const char *proplet_id,
                         const char *client_key, const char *channel_id) {
@@ -363,6 +584,12 @@ int mqtt_client_connect(const char *domain_id, const char *proplet_id,
 
   mqtt_client_init(&client_ctx);
 
+  /* Persistent session: the broker keeps subscriptions and queued QoS 1
+   * messages across reconnects, so a resumed connection skips the
+   * re-subscribe round trips (see subscribe()).
+   */
+  client_ctx.clean_session = 0U;
+
   strncpy(g_proplet_id, proplet_id, sizeof(g_proplet_id) - 1);
   g_proplet_id[sizeof(g_proplet_id) - 1] = '\0';
   strncpy(g_client_key, client_key ? client_key : "", sizeof(g_client_key) - 1);
@@ -496,6 +723,17 @@ int mqtt_client_connect(const char *domain_id, const char *proplet_id,
       return -errno;
     }
 
+    /* Cache the TLS session so reconnects resume instead of paying a
+     * full handshake. Best effort: older stacks without the option just
+     * handshake from scratch.
+     */
+    int session_cache = TLS_SESSION_CACHE_ENABLED;
+    ret = zsock_setsockopt(tls_sock, SOL_TLS, TLS_SESSION_CACHE,
+                           &session_cache, sizeof(session_cache));
+    if (ret < 0) {
+      LOG_WRN("TLS session caching unavailable [%d]", errno);
+    }
+
     /* Connect the TLS socket to the broker */
     ret = zsock_connect(tls_sock, (struct sockaddr *)&broker_addr,
                         sizeof(broker_addr));
@@ -523,7 +761,7 @@ int mqtt_client_connect(const char *domain_id, const char *proplet_id,
       continue;
     }
 
-    ret = poll_mqtt_socket(&client_ctx, 5000);
+    ret = poll_mqtt_socket(&client_ctx, 5000, false);
     if (ret < 0) {
       LOG_ERR("Socket poll failed, ret=%d. Retrying in 5 seconds...", ret);
       mqtt_abort(&client_ctx);
@@ -553,6 +791,14 @@ int subscribe(const char *domain_id, const char *channel_id) {
   static char stop_topic[128];
   static char registry_response_topic[128];
 
+  if (g_session_present) {
+    /* Broker restored our persistent session; subscriptions are intact */
+    LOG_INF("Session resumed, skipping re-subscribe for channel ID: %s",
+            channel_id);
+    g_subscription_ready = true;
+    return 0;
+  }
+
   snprintf(start_topic, sizeof(start_topic), START_TOPIC_TEMPLATE, domain_id,
            channel_id);
   snprintf(stop_topic, sizeof(stop_topic), STOP_TOPIC_TEMPLATE, domain_id,
@@ -595,178 +841,30 @@ int subscribe(const char *domain_id, const char *channel_id) {
   return ret;
 }
 
-void handle_start_command(const char *payload) {
-  cJSON *json = cJSON_Parse(payload);
-  if (json == NULL) {
-    const char *error_ptr = cJSON_GetErrorPtr();
-    if (error_ptr != NULL) {
-      LOG_ERR("JSON parsing error before: %s", error_ptr);
-    }
-    return;
-  }
-
+void handle_start_command(const char *payload, size_t payload_len) {
   struct task t = {0};
-  t.is_fl_task = false;
 
-  cJSON *id = cJSON_GetObjectItemCaseSensitive(json, "id");
-  cJSON *name = cJSON_GetObjectItemCaseSensitive(json, "name");
-  cJSON *image_url = cJSON_GetObjectItemCaseSensitive(json, "image_url");
-  cJSON *file = cJSON_GetObjectItemCaseSensitive(json, "file");
-  cJSON *inputs = cJSON_GetObjectItemCaseSensitive(json, "inputs");
-  cJSON *mode = cJSON_GetObjectItemCaseSensitive(json, "mode");
-  cJSON *fl_obj = cJSON_GetObjectItemCaseSensitive(json, "fl");
-  cJSON *env = cJSON_GetObjectItemCaseSensitive(json, "env");
-
-  if (!cJSON_IsString(id) || !cJSON_IsString(name)) {
+  /* Hot path: parse in place instead of building a cJSON tree */
+  TASK_TRACE_MARK(parse_start);
+  if (task_parser_parse(payload, payload_len, &t) != 0) {
     LOG_ERR("Invalid or missing mandatory fields in JSON payload");
-    cJSON_Delete(json);
     return;
   }
-
-  strncpy(t.id, id->valuestring, MAX_ID_LEN - 1);
-  t.id[MAX_ID_LEN - 1] = '\0';
-  strncpy(t.name, name->valuestring, MAX_NAME_LEN - 1);
-  t.name[MAX_NAME_LEN - 1] = '\0';
-
-  if (cJSON_IsString(mode)) {
-    strncpy(t.mode, mode->valuestring, MAX_NAME_LEN - 1);
-    t.mode[MAX_NAME_LEN - 1] = '\0';
-  }
-
-  if (cJSON_IsString(image_url)) {
-    strncpy(t.image_url, image_url->valuestring, MAX_URL_LEN - 1);
-    t.image_url[MAX_URL_LEN - 1] = '\0';
-  }
-
-  if (cJSON_IsString(file)) {
-    strncpy(t.file, file->valuestring, MAX_BASE64_LEN - 1);
-    t.file[MAX_BASE64_LEN - 1] = '\0';
-  }
-
-  if (cJSON_IsArray(inputs)) {
-    int input_count = cJSON_GetArraySize(inputs);
-    t.inputs_count =
-        (input_count > MAX_INPUTS) ? MAX_INPUTS : (size_t)input_count;
-    for (size_t i = 0; i < t.inputs_count; ++i) {
-      cJSON *input = cJSON_GetArrayItem(inputs, (int)i);
-      if (cJSON_IsNumber(input)) {
-        t.inputs[i] = (uint64_t)input->valuedouble;
-      }
-    }
-  }
-
-  // FL tasks are detected via ROUND_ID environment variable
-  // No need to parse FLSpec from JSON - all values come from env vars
+  TASK_TRACE_BEGIN(t.id);
+  TASK_TRACE_STAGE(t.id, TASK_TRACE_STAGE_PARSE, parse_start);
 
   t.model_data_fetched = false;
   t.dataset_data_fetched = false;
-  t.coordinator_url[0] = '\0';
-  t.model_registry_url[0] = '\0';
-  t.data_store_url[0] = '\0';
-  t.model_data[0] = '\0';
-  t.dataset_data[0] = '\0';
 
   const char *pid = g_proplet_id;
   strncpy(t.proplet_id, pid, sizeof(t.proplet_id) - 1);
   t.proplet_id[sizeof(t.proplet_id) - 1] = '\0';
 
-  if (env != NULL && cJSON_IsObject(env)) {
-    cJSON *round_id_env = cJSON_GetObjectItemCaseSensitive(env, "ROUND_ID");
-    cJSON *model_uri_env = cJSON_GetObjectItemCaseSensitive(env, "MODEL_URI");
-    cJSON *hyperparams_env =
-        cJSON_GetObjectItemCaseSensitive(env, "HYPERPARAMS");
-    cJSON *coordinator_url_env =
-        cJSON_GetObjectItemCaseSensitive(env, "MANAGER_COORDINATOR_URL");
-    cJSON *model_registry_url_env =
-        cJSON_GetObjectItemCaseSensitive(env, "MODEL_REGISTRY_URL");
-    cJSON *data_store_url_env =
-        cJSON_GetObjectItemCaseSensitive(env, "DATA_STORE_URL");
-
-    if (cJSON_IsString(coordinator_url_env)) {
-      strncpy(t.coordinator_url, coordinator_url_env->valuestring,
-              sizeof(t.coordinator_url) - 1);
-      t.coordinator_url[sizeof(t.coordinator_url) - 1] = '\0';
-    } else {
-      strncpy(t.coordinator_url, "http://coordinator-http:8080",
-              sizeof(t.coordinator_url) - 1);
-      t.coordinator_url[sizeof(t.coordinator_url) - 1] = '\0';
-    }
-
-    if (cJSON_IsString(model_registry_url_env)) {
-      strncpy(t.model_registry_url, model_registry_url_env->valuestring,
-              sizeof(t.model_registry_url) - 1);
-      t.model_registry_url[sizeof(t.model_registry_url) - 1] = '\0';
-    } else {
-      strncpy(t.model_registry_url, "http://model-registry:8081",
-              sizeof(t.model_registry_url) - 1);
-      t.model_registry_url[sizeof(t.model_registry_url) - 1] = '\0';
-    }
-
-    if (cJSON_IsString(data_store_url_env)) {
-      strncpy(t.data_store_url, data_store_url_env->valuestring,
-              sizeof(t.data_store_url) - 1);
-      t.data_store_url[sizeof(t.data_store_url) - 1] = '\0';
-    } else {
-      strncpy(t.data_store_url, "http://local-data-store:8083",
-              sizeof(t.data_store_url) - 1);
-      t.data_store_url[sizeof(t.data_store_url) - 1] = '\0';
-    }
-
-    if (cJSON_IsString(round_id_env)) {
-      strncpy(t.round_id, round_id_env->valuestring, sizeof(t.round_id) - 1);
-      t.round_id[sizeof(t.round_id) - 1] = '\0';
-      t.is_fml_task = true;
-      LOG_INF("FML task detected: ROUND_ID=%s", t.round_id);
-    }
-
-    if (cJSON_IsString(model_uri_env)) {
-      strncpy(t.model_uri, model_uri_env->valuestring, sizeof(t.model_uri) - 1);
-      t.model_uri[sizeof(t.model_uri) - 1] = '\0';
-      LOG_INF("FML model URI: %s", t.model_uri);
-    }
-
-    if (cJSON_IsString(hyperparams_env)) {
-      strncpy(t.hyperparams, hyperparams_env->valuestring,
-              sizeof(t.hyperparams) - 1);
-      t.hyperparams[sizeof(t.hyperparams) - 1] = '\0';
-    }
-
-    // FL task configuration from environment variables
-    cJSON *fl_round_id_env =
-        cJSON_GetObjectItemCaseSensitive(env, "FL_ROUND_ID");
-    cJSON *fl_format_env = cJSON_GetObjectItemCaseSensitive(env, "FL_FORMAT");
-    cJSON *fl_num_samples_env =
-        cJSON_GetObjectItemCaseSensitive(env, "FL_NUM_SAMPLES");
-
-    if (cJSON_IsString(fl_round_id_env)) {
-      strncpy(t.fl_round_id_str, fl_round_id_env->valuestring,
-              sizeof(t.fl_round_id_str) - 1);
-      t.fl_round_id_str[sizeof(t.fl_round_id_str) - 1] = '\0';
-    }
-    if (cJSON_IsString(fl_format_env)) {
-      strncpy(t.fl_format, fl_format_env->valuestring, MAX_NAME_LEN - 1);
-      t.fl_format[MAX_NAME_LEN - 1] = '\0';
-    } else {
-      // Default format
-      strncpy(t.fl_format, "f32-delta", MAX_NAME_LEN - 1);
-      t.fl_format[MAX_NAME_LEN - 1] = '\0';
-    }
-    if (cJSON_IsString(fl_num_samples_env)) {
-      strncpy(t.fl_num_samples_str, fl_num_samples_env->valuestring,
-              sizeof(t.fl_num_samples_str) - 1);
-      t.fl_num_samples_str[sizeof(t.fl_num_samples_str) - 1] = '\0';
-    } else {
-      strncpy(t.fl_num_samples_str, "1", sizeof(t.fl_num_samples_str) - 1);
-      t.fl_num_samples_str[sizeof(t.fl_num_samples_str) - 1] = '\0';
-    }
-  }
-
   LOG_INF("Starting task: ID=%s, Name=%s, Mode=%s", t.id, t.name, t.mode);
 
   if (t.is_fml_task) {
     if (strlen(t.round_id) == 0) {
       LOG_ERR("FML task missing required ROUND_ID field");
-      cJSON_Delete(json);
       return;
     }
     LOG_INF("FML Task: round_id=%s, model_uri=%s", t.round_id, t.model_uri);
@@ -803,22 +901,14 @@ void handle_start_command(const char *payload) {
 
     LOG_INF("FL/FML task: Fetching model from registry: %s", model_url);
 
-    char http_response[4096];
-    if (http_get_json(model_url, http_response, sizeof(http_response)) == 0) {
-      size_t response_len = strlen(http_response);
-      if (response_len >= sizeof(g_current_task.model_data) - 1) {
-        LOG_ERR("Model data too large (%zu >= %zu), cannot store, training "
-                "will fail",
-                response_len, sizeof(g_current_task.model_data) - 1);
-      } else {
-        strncpy(g_current_task.model_data, http_response,
-                sizeof(g_current_task.model_data) - 1);
-        g_current_task.model_data[sizeof(g_current_task.model_data) - 1] = '\0';
-        g_current_task.model_data_fetched = true;
-        LOG_INF(
-            "Successfully fetched model v%d via HTTP and stored in MODEL_DATA",
-            model_version);
-      }
+    size_t model_len = 0;
+    if (http_get(model_url, g_model_buf, sizeof(g_model_buf), &model_len) ==
+        0) {
+      g_current_task.model_data = g_model_buf;
+      g_current_task.model_data_len = model_len;
+      g_current_task.model_data_fetched = true;
+      LOG_INF("Successfully fetched model v%d via HTTP (%zu bytes)",
+              model_version, model_len);
     } else {
       LOG_WRN("HTTP model fetch failed, will use MQTT subscription for model "
               "topic: %s",
@@ -834,22 +924,14 @@ void handle_start_command(const char *payload) {
     LOG_INF("FL/FML task: Fetching dataset for proplet_id=%s from: %s",
             t.proplet_id, dataset_url);
 
-    char http_response[4096];
-    if (http_get_json(dataset_url, http_response, sizeof(http_response)) == 0) {
-      size_t response_len = strlen(http_response);
-      if (response_len >= sizeof(g_current_task.dataset_data) - 1) {
-        LOG_ERR("Dataset data too large (%zu >= %zu), cannot store, training "
-                "will fail",
-                response_len, sizeof(g_current_task.dataset_data) - 1);
-      } else {
-        strncpy(g_current_task.dataset_data, http_response,
-                sizeof(g_current_task.dataset_data) - 1);
-        g_current_task.dataset_data[sizeof(g_current_task.dataset_data) - 1] =
-            '\0';
-        g_current_task.dataset_data_fetched = true;
-        LOG_INF(
-            "Successfully fetched dataset via HTTP and stored in DATASET_DATA");
-      }
+    size_t dataset_len = 0;
+    if (http_get(dataset_url, g_dataset_buf, sizeof(g_dataset_buf),
+                 &dataset_len) == 0) {
+      g_current_task.dataset_data = g_dataset_buf;
+      g_current_task.dataset_data_len = dataset_len;
+      g_current_task.dataset_data_fetched = true;
+      LOG_INF("Successfully fetched dataset via HTTP (%zu bytes)",
+              dataset_len);
     } else {
       LOG_WRN("HTTP dataset fetch failed for proplet_id=%s (WASM client may "
               "use synthetic data)",
@@ -861,32 +943,61 @@ void handle_start_command(const char *payload) {
     size_t wasm_decoded_len = 0;
     static uint8_t wasm_binary[MAX_BASE64_LEN];
 
+    TASK_TRACE_MARK(decode_start);
     int ret = base64_decode(wasm_binary, sizeof(wasm_binary), &wasm_decoded_len,
                             (const uint8_t *)t.file, strlen(t.file));
     if (ret < 0) {
       LOG_ERR("Failed to decode base64 WASM (task.file). Err=%d", ret);
-      cJSON_Delete(json);
       return;
     }
+    TASK_TRACE_STAGE(t.id, TASK_TRACE_STAGE_DECODE, decode_start);
 
     g_current_task.file_len = wasm_decoded_len;
 
-    execute_wasm_module(t.id, wasm_binary, wasm_decoded_len, t.inputs,
-                        t.inputs_count);
+    ret = wasm_executor_submit(&g_current_task, wasm_binary, wasm_decoded_len);
+    if (ret != 0) {
+      extern const char *channel_id;
+      extern const char *domain_id;
+      publish_results_with_error(domain_id, channel_id, t.id, NULL,
+                                 (ret == -EAGAIN) ? "Executor queue full"
+                                                  : "Failed to queue task");
+    }
 
   } else if (strlen(t.image_url) > 0) {
-    LOG_INF("Requesting WASM from registry: %s", t.image_url);
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_registry_request(domain_id, channel_id, t.image_url);
+    /* Check the flash-backed cache before paying for a network fetch. The
+     * chunk reassembly buffer doubles as the read destination (the
+     * executor copies the bytes on submit); if a transfer is mid-flight
+     * the buffer is in use, so fall back to the registry.
+     */
+    size_t cached_len = 0;
+
+    if (!g_chunked_transfer.active &&
+        registry_cache_get(t.image_url, g_chunk_image_buf,
+                           sizeof(g_chunk_image_buf), &cached_len) == 0) {
+      LOG_INF("Using cached image for %s (%zu bytes), skipping fetch",
+              t.image_url, cached_len);
+      int ret =
+          wasm_executor_submit(&g_current_task, g_chunk_image_buf, cached_len);
+      if (ret != 0) {
+        extern const char *channel_id;
+        extern const char *domain_id;
+        publish_results_with_error(domain_id, channel_id, t.id, NULL,
+                                   (ret == -EAGAIN) ? "Executor queue full"
+                                                    : "Failed to queue task");
+      }
+    } else {
+      LOG_INF("Requesting WASM from registry: %s", t.image_url);
+      extern const char *channel_id;
+      extern const char *domain_id;
+      publish_registry_request(domain_id, channel_id, t.image_url);
+    }
   } else {
     LOG_WRN("No file or image_url specified; cannot start WASM task!");
   }
-  cJSON_Delete(json);
 }
 
-void handle_stop_command(const char *payload) {
-  cJSON *json = cJSON_Parse(payload);
+void handle_stop_command(const char *payload, size_t payload_len) {
+  cJSON *json = cJSON_ParseWithLength(payload, payload_len);
   if (!json) {
     LOG_ERR("Failed to parse JSON payload");
     return;
@@ -932,46 +1043,102 @@ void handle_stop_command(const char *payload) {
   cJSON_Delete(json);
 }
 
-static int http_get_json(const char *url, char *response_buffer,
-                         size_t buffer_size) {
-  int sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (sock < 0) {
-    LOG_ERR("Failed to create socket for HTTP GET: %d", sock);
-    return -1;
+/* Keep-alive connection pool for the coordinator/model-registry hosts. FL
+ * rounds issue several fetches back-to-back; reusing the TCP session skips
+ * connect + slow-start on every request. Fetches run on the MQTT thread
+ * only, so the pool needs no locking.
+ */
+#define HTTP_CONN_POOL_SIZE 2
+
+struct http_conn {
+  bool valid;
+  char host[256];
+  int port;
+  int sock;
+};
+
+static struct http_conn g_http_pool[HTTP_CONN_POOL_SIZE];
+
+static int http_pool_take(const char *host, int port) {
+  for (int i = 0; i < HTTP_CONN_POOL_SIZE; i++) {
+    struct http_conn *c = &g_http_pool[i];
+    if (c->valid && c->port == port && strcmp(c->host, host) == 0) {
+      c->valid = false;
+      return c->sock;
+    }
   }
+  return -1;
+}
 
-  char host[256] = {0};
-  int port = 80;
-  char path[512] = {0};
+static void http_pool_put(const char *host, int port, int sock) {
+  struct http_conn *slot = NULL;
 
+  for (int i = 0; i < HTTP_CONN_POOL_SIZE; i++) {
+    if (!g_http_pool[i].valid) {
+      slot = &g_http_pool[i];
+      break;
+    }
+  }
+  if (slot == NULL) {
+    slot = &g_http_pool[0];
+    zsock_close(slot->sock);
+  }
+
+  slot->valid = true;
+  strncpy(slot->host, host, sizeof(slot->host) - 1);
+  slot->host[sizeof(slot->host) - 1] = '\0';
+  slot->port = port;
+  slot->sock = sock;
+}
+
+static int http_parse_url(const char *url, char *host, size_t host_size,
+                          int *port, char *path, size_t path_size) {
   if (strncmp(url, "http://", 7) != 0) {
     LOG_ERR("Only http:// URLs are supported, got: %s", url);
-    zsock_close(sock);
     return -1;
   }
 
   const char *host_start = url + 7;
   const char *port_start = strchr(host_start, ':');
   const char *path_start = strchr(host_start, '/');
+  size_t host_len;
 
-  if (port_start && (!path_start || port_start < path_start)) {
-    size_t host_len = port_start - host_start;
-    strncpy(host, host_start, MIN(host_len, sizeof(host) - 1));
-    port = atoi(port_start + 1);
+  *port = 80;
 
-    if (path_start) {
-      strncpy(path, path_start, MIN(strlen(path_start), sizeof(path) - 1));
-    } else {
-      strcpy(path, "/");
-    }
+  if (port_start && (!path_start || port_start < path_start)) {
+    host_len = port_start - host_start;
   } else if (path_start) {
-    size_t host_len = path_start - host_start;
-    strncpy(host, host_start, MIN(host_len, sizeof(host) - 1));
-    strncpy(path, path_start, MIN(strlen(path_start), sizeof(path) - 1));
+    host_len = path_start - host_start;
+  } else {
+    host_len = strlen(host_start);
+  }
+
+  /* A truncated hostname would silently resolve to the wrong server */
+  if (host_len >= host_size) {
+    LOG_ERR("Hostname exceeds %zu bytes in URL: %s", host_size - 1, url);
+    return -1;
+  }
+  strncpy(host, host_start, host_len);
+  host[host_len] = '\0';
+
+  if (port_start && (!path_start || port_start < path_start)) {
+    *port = atoi(port_start + 1);
+  }
+
+  if (path_start) {
+    strncpy(path, path_start, MIN(strlen(path_start), path_size - 1));
   } else {
-    strncpy(host, host_start, MIN(strlen(host_start), sizeof(host) - 1));
     strcpy(path, "/");
   }
+  return 0;
+}
+
+static int http_connect(const char *host, int port) {
+  int sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock < 0) {
+    LOG_ERR("Failed to create socket for HTTP GET: %d", sock);
+    return -1;
+  }
 
   struct sockaddr_in addr;
   addr.sin_family = AF_INET;
@@ -999,25 +1166,39 @@ static int http_get_json(const char *url, char *response_buffer,
     LOG_WRN("Failed to set socket receive timeout: %d", ret);
   }
 
+  return sock;
+}
+
+/* Performs one request/response exchange on an established connection.
+ * Headers are accumulated in a small scratch buffer; body bytes stream
+ * directly into response_buffer as they arrive. Sets *reusable when the
+ * full Content-Length was consumed and the server did not ask to close.
+ *
+ * Returns 0 on success, -EAGAIN when the connection turned out to be dead
+ * before any response byte arrived (caller may retry on a fresh socket),
+ * -1 on a definitive failure.
+ */
+static int http_do_request(int sock, const char *host, const char *path,
+                           uint8_t *response_buffer, size_t buffer_size,
+                           size_t *received_len, bool *reusable) {
+  *reusable = false;
+
   char request[2048];
   int request_len = snprintf(request, sizeof(request),
                              "GET %s HTTP/1.1\r\n"
                              "Host: %s\r\n"
-                             "Connection: close\r\n"
+                             "Connection: keep-alive\r\n"
                              "\r\n",
                              path, host);
 
   if (request_len < 0 || request_len >= (int)sizeof(request)) {
     LOG_ERR("HTTP request too long or formatting error: %d", request_len);
-    zsock_close(sock);
     return -1;
   }
 
-  ret = zsock_send(sock, request, strlen(request), 0);
+  int ret = zsock_send(sock, request, request_len, 0);
   if (ret < 0) {
-    LOG_ERR("Failed to send HTTP request: %d", ret);
-    zsock_close(sock);
-    return -1;
+    return -EAGAIN;
   }
 
   size_t total_received = 0;
@@ -1027,105 +1208,144 @@ static int http_get_json(const char *url, char *response_buffer,
   size_t header_buffer_len = 0;
   int http_status_code = 0;
 
-  while (total_received < buffer_size - 1) {
+  while (!headers_complete) {
     char chunk[512];
-    ret = zsock_recv(sock, chunk, sizeof(chunk) - 1, 0);
+    ret = zsock_recv(sock, chunk, sizeof(chunk), 0);
     if (ret <= 0) {
-      break;
+      /* A pooled connection closed by the server looks like EOF before any
+       * response byte: let the caller retry on a fresh socket.
+       */
+      return (header_buffer_len == 0) ? -EAGAIN : -1;
     }
-    chunk[ret] = '\0';
-
-    if (!headers_complete) {
-      size_t header_space = sizeof(header_buffer) - header_buffer_len - 1;
-      size_t copy_len = MIN((size_t)ret, header_space);
-      memcpy(header_buffer + header_buffer_len, chunk, copy_len);
-      header_buffer_len += copy_len;
-      header_buffer[header_buffer_len] = '\0';
-
-      char *header_end = strstr(header_buffer, "\r\n\r\n");
-      if (header_end) {
-        headers_complete = true;
-        size_t header_len = (header_end - header_buffer) + 4;
-
-        char *status_line = header_buffer;
-        char *http_version_end = strchr(status_line, ' ');
-        if (http_version_end) {
-          char *status_code_start = http_version_end + 1;
-          char *status_code_end = strchr(status_code_start, ' ');
-          if (status_code_end) {
-            char status_code_str[16];
-            size_t code_len = status_code_end - status_code_start;
-            if (code_len < sizeof(status_code_str)) {
-              memcpy(status_code_str, status_code_start, code_len);
-              status_code_str[code_len] = '\0';
-              http_status_code = atoi(status_code_str);
-              LOG_INF("HTTP status code: %d", http_status_code);
-            }
-          }
-        }
-
-        if (http_status_code < 200 || http_status_code >= 300) {
-          LOG_ERR("HTTP request failed with status: %d", http_status_code);
-          zsock_close(sock);
-          return -1;
-        }
-
-        size_t body_start_in_chunk = 0;
-        if (header_len > (header_buffer_len - copy_len)) {
-          body_start_in_chunk = header_len - header_buffer_len + copy_len;
-        }
 
-        char *cl_header = strstr(header_buffer, "Content-Length:");
-        if (cl_header) {
-          const char *val_start = cl_header + strlen("Content-Length:");
-          char *endptr;
-          unsigned long cl_val = strtoul(val_start, &endptr, 10);
-          if (endptr != val_start && cl_val <= (unsigned long)SIZE_MAX) {
-            content_length = (size_t)cl_val;
-          }
-        }
+    size_t header_space = sizeof(header_buffer) - header_buffer_len - 1;
+    size_t copy_len = MIN((size_t)ret, header_space);
+    memcpy(header_buffer + header_buffer_len, chunk, copy_len);
+    header_buffer_len += copy_len;
+    header_buffer[header_buffer_len] = '\0';
 
-        if (body_start_in_chunk < (size_t)ret) {
-          size_t body_len = ret - body_start_in_chunk;
-          if (total_received + body_len < buffer_size - 1) {
-            memcpy(response_buffer + total_received,
-                   chunk + body_start_in_chunk, body_len);
-            total_received += body_len;
-          }
-        }
-      } else if (header_buffer_len >= sizeof(header_buffer) - 1) {
+    char *header_end = strstr(header_buffer, "\r\n\r\n");
+    if (header_end == NULL) {
+      if (header_buffer_len >= sizeof(header_buffer) - 1) {
         LOG_ERR("HTTP headers too long or malformed");
-        size_t body_len =
-            (size_t)ret - (sizeof(header_buffer) - 1 - header_buffer_len);
-        if (body_len > 0 && total_received + body_len < buffer_size - 1) {
-          memcpy(response_buffer + total_received,
-                 chunk + (sizeof(header_buffer) - 1 - header_buffer_len),
-                 body_len);
-          total_received += body_len;
-        }
-        zsock_close(sock);
         return -1;
       }
-    } else {
-      size_t copy_len = MIN((size_t)ret, buffer_size - total_received - 1);
-      memcpy(response_buffer + total_received, chunk, copy_len);
-      total_received += copy_len;
+      continue;
     }
 
-    if (content_length > 0 && total_received >= content_length) {
-      break;
+    headers_complete = true;
+    size_t header_len = (header_end - header_buffer) + 4;
+
+    char *http_version_end = strchr(header_buffer, ' ');
+    if (http_version_end) {
+      http_status_code = atoi(http_version_end + 1);
+      LOG_INF("HTTP status code: %d", http_status_code);
+    }
+
+    if (http_status_code < 200 || http_status_code >= 300) {
+      LOG_ERR("HTTP request failed with status: %d", http_status_code);
+      return -1;
+    }
+
+    char *cl_header = strstr(header_buffer, "Content-Length:");
+    if (cl_header) {
+      const char *val_start = cl_header + strlen("Content-Length:");
+      char *endptr;
+      unsigned long cl_val = strtoul(val_start, &endptr, 10);
+      if (endptr != val_start && cl_val <= (unsigned long)SIZE_MAX) {
+        content_length = (size_t)cl_val;
+      }
+    }
+
+    /* Any body bytes that arrived in the same chunk as the headers. The
+     * header scratch buffer may have clipped the chunk, so recompute the
+     * body offset relative to the chunk.
+     */
+    size_t body_start_in_chunk = header_len - (header_buffer_len - copy_len);
+    if (body_start_in_chunk < (size_t)ret) {
+      size_t body_len = (size_t)ret - body_start_in_chunk;
+      body_len = MIN(body_len, buffer_size);
+      memcpy(response_buffer, chunk + body_start_in_chunk, body_len);
+      total_received = body_len;
     }
   }
 
-  response_buffer[total_received] = '\0';
-  zsock_close(sock);
+  /* Stream the remaining body straight into the destination buffer */
+  while (total_received < buffer_size &&
+         (content_length == 0 || total_received < content_length)) {
+    size_t want = buffer_size - total_received;
+    if (content_length > 0) {
+      want = MIN(want, content_length - total_received);
+    }
+    ret = zsock_recv(sock, response_buffer + total_received, want, 0);
+    if (ret <= 0) {
+      break;
+    }
+    total_received += (size_t)ret;
+  }
 
   if (total_received == 0) {
-    LOG_WRN("No data received from HTTP GET %s", url);
+    LOG_WRN("No data received from HTTP GET http://%s%s", host, path);
+    return -1;
+  }
+
+  *reusable = content_length > 0 && total_received == content_length &&
+              strstr(header_buffer, "Connection: close") == NULL;
+  *received_len = total_received;
+  return 0;
+}
+
+/* Binary-safe HTTP GET over a pooled keep-alive connection: the body is
+ * written as raw bytes into response_buffer and its length reported via
+ * received_len.
+ */
+static int http_get(const char *url, uint8_t *response_buffer,
+                    size_t buffer_size, size_t *received_len) {
+  char host[256] = {0};
+  char path[512] = {0};
+  int port = 80;
+
+  if (http_parse_url(url, host, sizeof(host), &port, path, sizeof(path)) !=
+      0) {
+    return -1;
+  }
+
+  bool reused = true;
+  int sock = http_pool_take(host, port);
+  if (sock < 0) {
+    reused = false;
+    sock = http_connect(host, port);
+    if (sock < 0) {
+      return -1;
+    }
+  }
+
+  bool reusable = false;
+  int ret = http_do_request(sock, host, path, response_buffer, buffer_size,
+                            received_len, &reusable);
+  if (ret == -EAGAIN && reused) {
+    /* Pooled session went stale; retry once on a fresh connection */
+    zsock_close(sock);
+    sock = http_connect(host, port);
+    if (sock < 0) {
+      return -1;
+    }
+    ret = http_do_request(sock, host, path, response_buffer, buffer_size,
+                          received_len, &reusable);
+  }
+
+  if (ret == 0 && reusable) {
+    http_pool_put(host, port, sock);
+  } else {
+    zsock_close(sock);
+  }
+
+  if (ret != 0) {
     return -1;
   }
 
-  LOG_INF("HTTP GET %s successful, received %zu bytes", url, total_received);
+  LOG_INF("HTTP GET %s successful, received %zu bytes%s", url, *received_len,
+          reusable ? " (connection kept alive)" : "");
   return 0;
 }
 
@@ -1160,8 +1380,89 @@ static int extract_model_version_from_uri(const char *uri) {
   return version;
 }
 
-int handle_registry_response(const char *payload) {
-  cJSON *json = cJSON_Parse(payload);
+static int handle_registry_chunk(const char *app_name, const char *data_b64,
+                                 int idx, int total, cJSON *crc) {
+  struct chunked_transfer *xfer = &g_chunked_transfer;
+
+  if (total < 1) {
+    LOG_ERR("Invalid total_chunks %d in registry chunk", total);
+    chunked_transfer_reset();
+    return -1;
+  }
+
+  if (idx == 0) {
+    chunked_transfer_reset();
+    xfer->buffer = g_chunk_image_buf;
+    strncpy(xfer->app_name, app_name, sizeof(xfer->app_name) - 1);
+    xfer->total_chunks = total;
+    xfer->active = true;
+  } else if (!xfer->active || idx != xfer->next_idx ||
+             total != xfer->total_chunks ||
+             strncmp(xfer->app_name, app_name, sizeof(xfer->app_name)) != 0) {
+    LOG_ERR("Out-of-sequence registry chunk %d/%d for %s, aborting transfer",
+            idx, total, app_name);
+    chunked_transfer_reset();
+    return -1;
+  }
+
+  if (cJSON_IsNumber(crc)) {
+    xfer->expected_crc = (uint32_t)crc->valuedouble;
+    xfer->has_crc = true;
+  }
+
+  /* Decode this segment straight into the destination buffer */
+  size_t decoded_len = 0;
+  TASK_TRACE_MARK(decode_start);
+  int ret = base64_decode(xfer->buffer + xfer->received_len,
+                          WASM_IMAGE_MAX_SIZE - xfer->received_len,
+                          &decoded_len, (const uint8_t *)data_b64,
+                          strlen(data_b64));
+  if (ret < 0) {
+    LOG_ERR("Failed to decode registry chunk %d/%d, err=%d", idx, total, ret);
+    chunked_transfer_reset();
+    return -1;
+  }
+  TASK_TRACE_STAGE(g_current_task.id, TASK_TRACE_STAGE_DECODE, decode_start);
+
+  xfer->received_len += decoded_len;
+  xfer->next_idx = idx + 1;
+
+  LOG_INF("Registry chunk %d/%d for %s (%zu bytes total)", idx + 1, total,
+          app_name, xfer->received_len);
+
+  if (xfer->next_idx < xfer->total_chunks) {
+    return 0;
+  }
+
+  if (xfer->has_crc) {
+    uint32_t actual = crc32_ieee(xfer->buffer, xfer->received_len);
+    if (actual != xfer->expected_crc) {
+      LOG_ERR("Registry image CRC mismatch (got 0x%08x, want 0x%08x)", actual,
+              xfer->expected_crc);
+      chunked_transfer_reset();
+      return -1;
+    }
+  }
+
+  LOG_INF("Chunked WASM image complete (%zu bytes). Queueing for execution...",
+          xfer->received_len);
+
+  (void)registry_cache_put(xfer->app_name, xfer->buffer, xfer->received_len);
+
+  ret = wasm_executor_submit(&g_current_task, xfer->buffer,
+                             xfer->received_len);
+  if (ret != 0) {
+    publish_results_with_error(domain_id, channel_id, g_current_task.id, NULL,
+                               (ret == -EAGAIN) ? "Executor queue full"
+                                                : "Failed to queue task");
+  }
+
+  chunked_transfer_reset();
+  return ret;
+}
+
+int handle_registry_response(const char *payload, size_t payload_len) {
+  cJSON *json = cJSON_ParseWithLength(payload, payload_len);
   if (!json) {
     LOG_ERR("Failed to parse JSON payload");
     return -1;
@@ -1172,6 +1473,26 @@ int handle_registry_response(const char *payload) {
 
   cJSON *app_name = cJSON_GetObjectItemCaseSensitive(json, "app_name");
   cJSON *data = cJSON_GetObjectItemCaseSensitive(json, "data");
+  cJSON *chunk_idx = cJSON_GetObjectItemCaseSensitive(json, "chunk_idx");
+
+  if (cJSON_IsNumber(chunk_idx)) {
+    cJSON *total_chunks = cJSON_GetObjectItemCaseSensitive(json, "total_chunks");
+    cJSON *crc = cJSON_GetObjectItemCaseSensitive(json, "crc32");
+
+    if (!cJSON_IsString(app_name) || !app_name->valuestring ||
+        !cJSON_IsString(data) || !data->valuestring ||
+        !cJSON_IsNumber(total_chunks)) {
+      LOG_ERR("Invalid chunked registry response");
+      cJSON_Delete(json);
+      return -1;
+    }
+
+    int ret = handle_registry_chunk(app_name->valuestring, data->valuestring,
+                                    chunk_idx->valueint,
+                                    total_chunks->valueint, crc);
+    cJSON_Delete(json);
+    return ret;
+  }
 
   if (cJSON_IsString(app_name) && app_name->valuestring) {
     strncpy(resp.app_name, app_name->valuestring, sizeof(resp.app_name) - 1);
@@ -1202,6 +1523,7 @@ int handle_registry_response(const char *payload) {
   }
 
   size_t actual_decoded_len = decoded_len;
+  TASK_TRACE_MARK(decode_start);
   int ret = base64_decode(binary_data, decoded_len, &actual_decoded_len,
                           (const uint8_t *)resp.data, encoded_len);
   if (ret < 0) {
@@ -1210,17 +1532,28 @@ int handle_registry_response(const char *payload) {
     cJSON_Delete(json);
     return -1;
   }
+  TASK_TRACE_STAGE(g_current_task.id, TASK_TRACE_STAGE_DECODE, decode_start);
 
-  LOG_INF("Decoded single-chunk WASM size: %zu. Executing now...",
+  LOG_INF("Decoded single-chunk WASM size: %zu. Queueing for execution...",
           actual_decoded_len);
 
-  execute_wasm_module(g_current_task.id, binary_data, actual_decoded_len,
-                      g_current_task.inputs, g_current_task.inputs_count);
+  (void)registry_cache_put(resp.app_name, binary_data, actual_decoded_len);
+
+  ret = wasm_executor_submit(&g_current_task, binary_data,
+                             actual_decoded_len);
+  if (ret != 0) {
+    publish_results_with_error(domain_id, channel_id, g_current_task.id, NULL,
+                               (ret == -EAGAIN) ? "Executor queue full"
+                                                : "Failed to queue task");
+    free(binary_data);
+    cJSON_Delete(json);
+    return ret;
+  }
 
   free(binary_data);
   cJSON_Delete(json);
 
-  LOG_INF("WASM binary executed from single-chunk registry response.");
+  LOG_INF("WASM binary queued from single-chunk registry response.");
   return 0;
 }
 
@@ -1230,6 +1563,19 @@ void publish_alive_message(const char *domain_id, const char *channel_id) {
   const char *pid = g_proplet_id;
   const char *ns = (g_namespace != NULL) ? g_namespace : DEFAULT_NAMESPACE;
 
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+  uint8_t cbor_buf[192];
+  size_t cbor_len = 0;
+
+  if (cbor_codec_encode_alive(cbor_buf, sizeof(cbor_buf), &cbor_len, pid, ns) ==
+      0) {
+    (void)publish_raw(domain_id, channel_id, ALIVE_TOPIC_TEMPLATE, cbor_buf,
+                      cbor_len);
+    return;
+  }
+  LOG_WRN("CBOR alive encoding failed, falling back to JSON");
+#endif
+
   snprintf(payload, sizeof(payload),
            "{\"status\":\"alive\",\"proplet_id\":\"%s\",\"namespace\":\"%s\"}",
            pid, ns);
@@ -1287,6 +1633,20 @@ void publish_metrics_message(const char *domain_id, const char *channel_id,
                             (double)heap_max_alloc);
   }
 
+  uint32_t pool_total = 0U;
+  uint32_t pool_free = 0U;
+  uint32_t pool_highmark = 0U;
+
+  if (wasm_handler_get_pool_stats(&pool_total, &pool_free, &pool_highmark) ==
+      0) {
+    cJSON *pool = cJSON_AddObjectToObject(root, "wamr_pool");
+    if (pool != NULL) {
+      cJSON_AddNumberToObject(pool, "total_bytes", (double)pool_total);
+      cJSON_AddNumberToObject(pool, "free_bytes", (double)pool_free);
+      cJSON_AddNumberToObject(pool, "highmark_bytes", (double)pool_highmark);
+    }
+  }
+
   char *payload = cJSON_PrintUnformatted(root);
   if (payload != NULL) {
     (void)publish(domain_id, channel_id, METRICS_TOPIC_TEMPLATE, payload);
@@ -1296,25 +1656,6 @@ void publish_metrics_message(const char *domain_id, const char *channel_id,
   cJSON_Delete(root);
 }
 
-static cJSON *parse_tags(const char *tags_str) {
-  cJSON *arr = cJSON_CreateArray();
-  if (!tags_str || tags_str[0] == '\0') {
-    return arr;
-  }
-  char buf[256];
-  strncpy(buf, tags_str, sizeof(buf) - 1);
-  buf[sizeof(buf) - 1] = '\0';
-  char *token = strtok(buf, ",");
-  while (token) {
-    while (*token == ' ') {
-      token++;
-    }
-    cJSON_AddItemToArray(arr, cJSON_CreateString(token));
-    token = strtok(NULL, ",");
-  }
-  return arr;
-}
-
 int publish_discovery(const char *domain_id, const char *proplet_id,
                       const char *channel_id, const char *description,
                       const char *tags, const char *location,
@@ -1363,52 +1704,117 @@ int publish_discovery(const char *domain_id, const char *proplet_id,
 
   const char *ns = (g_namespace != NULL) ? g_namespace : DEFAULT_NAMESPACE;
 
-  cJSON *root = cJSON_CreateObject();
-  if (root == NULL) {
-    LOG_ERR("Failed to allocate discovery JSON object.");
-    return -ENOMEM;
+  /* Warm-boot fast path: reuse the payload rendered on a previous boot
+   * when none of the discovery inputs changed, and refresh the cache
+   * otherwise so the next reboot skips straight to the publish.
+   */
+  uint32_t inputs_crc = 0;
+  const char *crc_inputs[] = {
+      proplet_id,
+      ns,
+      description ? description : "",
+      tags ? tags : "",
+      location ? location : "",
+      version ? version : "",
+      ip_str,
+      hostname ? hostname : "",
+      cpu_arch,
+      IS_ENABLED(CONFIG_PROPLET_CBOR_ENCODING) ? "cbor" : "",
+      PROPLET_WAMR_AOT ? "aot" : "",
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(crc_inputs); i++) {
+    inputs_crc = crc32_ieee_update(inputs_crc, (const uint8_t *)crc_inputs[i],
+                                   strlen(crc_inputs[i]) + 1);
+  }
+  inputs_crc = crc32_ieee_update(inputs_crc, (const uint8_t *)&total_memory,
+                                 sizeof(total_memory));
+
+  static char discovery_payload[1024];
+  struct json_writer w;
+
+  if (discovery_cache_get(inputs_crc, discovery_payload,
+                          sizeof(discovery_payload)) == 0) {
+    LOG_INF("Reusing cached discovery payload");
+    goto publish;
+  }
+
+  jw_init(&w, discovery_payload, sizeof(discovery_payload));
+  jw_object_begin(&w);
+  jw_kv_string(&w, "proplet_id", proplet_id);
+  jw_kv_string(&w, "namespace", ns);
+
+  jw_key(&w, "metadata");
+  jw_object_begin(&w);
+  jw_kv_string(&w, "description", description ? description : "");
+
+  jw_key(&w, "tags");
+  jw_array_begin(&w);
+  if (tags != NULL && tags[0] != '\0') {
+    char tags_buf[256];
+    strncpy(tags_buf, tags, sizeof(tags_buf) - 1);
+    tags_buf[sizeof(tags_buf) - 1] = '\0';
+    char *token = strtok(tags_buf, ",");
+    while (token) {
+      while (*token == ' ') {
+        token++;
+      }
+      jw_string(&w, token);
+      token = strtok(NULL, ",");
+    }
   }
+  jw_array_end(&w);
+
+  jw_kv_string(&w, "location", location ? location : "");
+  jw_kv_string(&w, "ip", ip_str);
+  jw_kv_string(&w, "environment", "embedded");
+  jw_kv_string(&w, "os", "zephyr");
+  jw_kv_string(&w, "hostname", hostname ? hostname : "");
+  jw_kv_string(&w, "cpu_arch", cpu_arch);
+  jw_kv_uint(&w, "total_memory_bytes", total_memory);
+  jw_kv_string(&w, "proplet_version", version ? version : "");
+  jw_kv_string(&w, "wasm_runtime", "wamr");
+
+  /* Module formats this runtime build can execute; the scheduler picks
+   * AOT artifacts compiled for our cpu_arch when available.
+   */
+  jw_key(&w, "wasm_formats");
+  jw_array_begin(&w);
+  jw_string(&w, "wasm");
+#if PROPLET_WAMR_AOT
+  jw_string(&w, "aot");
+#endif
+  jw_array_end(&w);
+
+  /* Advertise supported payload encodings so the manager can decode the
+   * results/metrics topics for this proplet. Discovery itself stays JSON.
+   */
+  jw_key(&w, "encodings");
+  jw_array_begin(&w);
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+  jw_string(&w, "cbor");
+#endif
+  jw_string(&w, "json");
+  jw_array_end(&w);
 
-  cJSON_AddStringToObject(root, "proplet_id", proplet_id);
-  cJSON_AddStringToObject(root, "namespace", ns);
+  jw_object_end(&w);
+  jw_object_end(&w);
 
-  cJSON *metadata = cJSON_CreateObject();
-  if (metadata == NULL) {
-    cJSON_Delete(root);
-    LOG_ERR("Failed to allocate metadata JSON object.");
+  if (!jw_ok(&w)) {
+    LOG_ERR("Discovery payload exceeds buffer.");
     return -ENOMEM;
   }
-  cJSON_AddStringToObject(metadata, "description",
-                          description ? description : "");
-  cJSON_AddItemToObject(metadata, "tags", parse_tags(tags));
-  cJSON_AddStringToObject(metadata, "location", location ? location : "");
-  cJSON_AddStringToObject(metadata, "ip", ip_str);
-  cJSON_AddStringToObject(metadata, "environment", "embedded");
-  cJSON_AddStringToObject(metadata, "os", "zephyr");
-  cJSON_AddStringToObject(metadata, "hostname", hostname ? hostname : "");
-  cJSON_AddStringToObject(metadata, "cpu_arch", cpu_arch);
-  cJSON_AddNumberToObject(metadata, "total_memory_bytes", (double)total_memory);
-  cJSON_AddStringToObject(metadata, "proplet_version", version ? version : "");
-  cJSON_AddStringToObject(metadata, "wasm_runtime", "wamr");
-  cJSON_AddItemToObject(root, "metadata", metadata);
-
-  char *payload = cJSON_PrintUnformatted(root);
-  cJSON_Delete(root);
 
-  if (payload == NULL) {
-    LOG_ERR("Failed to serialise discovery JSON.");
-    return -ENOMEM;
-  }
+  (void)discovery_cache_put(inputs_crc, discovery_payload);
 
+publish:;
   char topic[128];
   snprintf(topic, sizeof(topic), DISCOVERY_TOPIC_TEMPLATE, domain_id,
            channel_id);
 
   struct mqtt_publish_param param;
-  prepare_publish_param(&param, topic, payload);
+  prepare_publish_param(&param, topic, discovery_payload);
 
   int ret = mqtt_publish(&client_ctx, &param);
-  cJSON_free(payload);
 
   if (ret != 0) {
     LOG_ERR("Failed to publish discovery. Error: %d", ret);
@@ -1437,81 +1843,12 @@ void publish_results(const char *domain_id, const char *channel_id,
   publish_results_with_error(domain_id, channel_id, task_id, results, NULL);
 }
 
-static void json_escape_string(char *dest, size_t dest_size, const char *src) {
-  if (!src || dest_size == 0) {
-    if (dest_size > 0) {
-      dest[0] = '\0';
-    }
-    return;
-  }
-
-  size_t j = 0;
-  for (size_t i = 0; src[i] != '\0' && j < dest_size - 1; i++) {
-    switch (src[i]) {
-    case '"':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = '"';
-      }
-      break;
-    case '\\':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = '\\';
-      }
-      break;
-    case '\b':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = 'b';
-      }
-      break;
-    case '\f':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = 'f';
-      }
-      break;
-    case '\n':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = 'n';
-      }
-      break;
-    case '\r':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = 'r';
-      }
-      break;
-    case '\t':
-      if (j + 2 < dest_size) {
-        dest[j++] = '\\';
-        dest[j++] = 't';
-      }
-      break;
-    default:
-      if (j < dest_size - 1) {
-        dest[j++] = src[i];
-      }
-      break;
-    }
-  }
-  dest[j] = '\0';
-}
-
 void publish_results_with_error(const char *domain_id, const char *channel_id,
                                 const char *task_id, const char *results,
                                 const char *error_msg) {
   char results_payload[2048];
-  char escaped_error[MAX_ERROR_MSG_LEN * 2];
   const char *pid = g_proplet_id;
-
-  if (error_msg) {
-    json_escape_string(escaped_error, sizeof(escaped_error), error_msg);
-  } else {
-    escaped_error[0] = '\0';
-  }
+  struct json_writer w;
 
   if (g_current_task.is_fml_task && strlen(g_current_task.round_id) > 0) {
     cJSON *update_json = NULL;
@@ -1524,18 +1861,16 @@ void publish_results_with_error(const char *domain_id, const char *channel_id,
              g_current_task.round_id, pid);
 
     if (error_msg) {
-      snprintf(results_payload, sizeof(results_payload),
-               "{"
-               "\"round_id\":\"%s\","
-               "\"proplet_id\":\"%s\","
-               "\"base_model_uri\":\"%s\","
-               "\"num_samples\":0,"
-               "\"metrics\":{},"
-               "\"update\":{},"
-               "\"error\":\"%s\""
-               "}",
-               g_current_task.round_id, pid, g_current_task.model_uri,
-               escaped_error);
+      jw_init(&w, results_payload, sizeof(results_payload));
+      jw_object_begin(&w);
+      jw_kv_string(&w, "round_id", g_current_task.round_id);
+      jw_kv_string(&w, "proplet_id", pid);
+      jw_kv_string(&w, "base_model_uri", g_current_task.model_uri);
+      jw_kv_uint(&w, "num_samples", 0);
+      jw_kv_raw(&w, "metrics", "{}");
+      jw_kv_raw(&w, "update", "{}");
+      jw_kv_string(&w, "error", error_msg);
+      jw_object_end(&w);
     } else if (update_json) {
       cJSON *round_id_obj =
           cJSON_GetObjectItemCaseSensitive(update_json, "round_id");
@@ -1652,59 +1987,68 @@ void publish_results_with_error(const char *domain_id, const char *channel_id,
                                    ? g_current_task.round_id
                                    : "";
 
+    jw_init(&w, results_payload, sizeof(results_payload));
+    jw_object_begin(&w);
+    jw_kv_string(&w, "task_id", task_id);
+    jw_key(&w, "results");
+    jw_object_begin(&w);
+    jw_kv_string(&w, "task_id", task_id);
+    jw_kv_string(&w, "round_id", round_id_str);
+    jw_kv_string(&w, "proplet_id", pid);
+    jw_kv_uint(&w, "num_samples", num_samples);
+    jw_kv_string(&w, "update_b64", error_msg ? "" : update_b64);
+    jw_kv_string(&w, "format", format);
+    jw_kv_raw(&w, "metrics", "{}");
+    jw_object_end(&w);
     if (error_msg) {
-      snprintf(results_payload, sizeof(results_payload),
-               "{"
-               "\"task_id\":\"%s\","
-               "\"results\":{"
-               "\"task_id\":\"%s\","
-               "\"round_id\":\"%s\","
-               "\"proplet_id\":\"%s\","
-               "\"num_samples\":%llu,"
-               "\"update_b64\":\"\","
-               "\"format\":\"%s\","
-               "\"metrics\":{}"
-               "},"
-               "\"error\":\"%s\""
-               "}",
-               task_id, task_id, round_id_str, pid,
-               (unsigned long long)num_samples, format, escaped_error);
-    } else {
-      snprintf(results_payload, sizeof(results_payload),
-               "{"
-               "\"task_id\":\"%s\","
-               "\"results\":{"
-               "\"task_id\":\"%s\","
-               "\"round_id\":\"%s\","
-               "\"proplet_id\":\"%s\","
-               "\"num_samples\":%llu,"
-               "\"update_b64\":\"%s\","
-               "\"format\":\"%s\","
-               "\"metrics\":{}"
-               "}"
-               "}",
-               task_id, task_id, round_id_str, pid,
-               (unsigned long long)num_samples, update_b64, format);
+      jw_kv_string(&w, "error", error_msg);
+    }
+    jw_object_end(&w);
+    if (!jw_ok(&w)) {
+      LOG_ERR("FL update envelope exceeds payload buffer");
+      return;
     }
 
     LOG_INF("Publishing FL update envelope for task: %s (round=%s, error=%s)",
             task_id, round_id_str, error_msg ? error_msg : "none");
   } else {
-    char escaped_results[2048];
-    if (results) {
-      json_escape_string(escaped_results, sizeof(escaped_results), results);
-    } else {
-      escaped_results[0] = '\0';
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+    /* CBOR carries the result string verbatim, so no escaping pass. Stack
+     * allocation, like the JSON payload buffer: both the executor and the
+     * MQTT thread publish results, so a static buffer would be shared.
+     */
+    uint8_t cbor_buf[2048];
+    size_t cbor_len = 0;
+
+    if (cbor_codec_encode_result(cbor_buf, sizeof(cbor_buf), &cbor_len, task_id,
+                                 results, error_msg) == 0) {
+      if (publish_raw(domain_id, channel_id, RESULTS_TOPIC_TEMPLATE, cbor_buf,
+                      cbor_len) != 0) {
+        LOG_ERR("Failed to publish results");
+      } else {
+        LOG_INF("Published results for task: %s", task_id);
+      }
+      return;
     }
+    LOG_WRN("CBOR result encoding failed, falling back to JSON");
+#endif
 
+    jw_init(&w, results_payload, sizeof(results_payload));
+    jw_object_begin(&w);
+    jw_kv_string(&w, "task_id", task_id);
+    jw_kv_string(&w, "results", results);
     if (error_msg) {
-      snprintf(results_payload, sizeof(results_payload),
-               "{\"task_id\":\"%s\",\"results\":\"%s\",\"error\":\"%s\"}",
-               task_id, escaped_results, escaped_error);
-    } else {
-      snprintf(results_payload, sizeof(results_payload),
-               "{\"task_id\":\"%s\",\"results\":\"%s\"}", task_id,
-               escaped_results);
+      jw_kv_string(&w, "error", error_msg);
+    }
+    jw_object_end(&w);
+    if (!jw_ok(&w)) {
+      LOG_ERR("Result payload exceeds buffer, truncating results");
+      jw_init(&w, results_payload, sizeof(results_payload));
+      jw_object_begin(&w);
+      jw_kv_string(&w, "task_id", task_id);
+      jw_kv_string(&w, "results", "");
+      jw_kv_string(&w, "error", "Result payload exceeded buffer");
+      jw_object_end(&w);
     }
   }
 
@@ -1716,87 +2060,218 @@ void publish_results_with_error(const char *domain_id, const char *channel_id,
   }
 }
 
-void publish_task_metrics(const char *domain_id, const char *channel_id,
-                          const char *task_id, const char *proplet_id) {
+/* Writes the per-task metrics object shared by the single-task and batched
+ * publish paths. Returns false when no metrics exist for the task.
+ */
+static bool write_task_metrics(struct json_writer *w, const char *task_id,
+                               const char *proplet_id) {
   task_metrics_t metrics;
 
   if (task_monitor_get_metrics(task_id, &metrics) != 0) {
     LOG_DBG("No metrics available for task: %s", task_id);
-    return;
+    return false;
+  }
+
+  jw_object_begin(w);
+  jw_kv_string(w, "task_id", task_id);
+  jw_kv_string(w, "proplet_id", proplet_id);
+  jw_kv_uint(w, "timestamp", (uint64_t)k_uptime_get());
+
+  jw_key(w, "metrics");
+  jw_object_begin(w);
+  jw_kv_number(w, "cpu_percent", metrics.current.cpu_percent);
+  jw_kv_uint(w, "memory_bytes", metrics.current.memory_bytes);
+  jw_kv_number(w, "memory_percent", metrics.current.memory_percent);
+  jw_kv_uint(w, "disk_read_bytes", 0);
+  jw_kv_uint(w, "disk_write_bytes", 0);
+  jw_kv_uint(w, "uptime_seconds", (uint64_t)metrics.current.uptime_seconds);
+  jw_kv_uint(w, "thread_count", metrics.current.thread_count);
+  jw_kv_uint(w, "file_descriptor_count", 0);
+  jw_object_end(w);
+
+  jw_key(w, "aggregated");
+  jw_object_begin(w);
+  jw_kv_number(w, "avg_cpu_usage", metrics.aggregated.avg_cpu_usage);
+  jw_kv_number(w, "min_cpu_usage", metrics.aggregated.min_cpu_usage);
+  jw_kv_number(w, "max_cpu_usage", metrics.aggregated.max_cpu_usage);
+  jw_kv_number(w, "p95_cpu_usage", metrics.aggregated.p95_cpu_usage);
+  jw_kv_uint(w, "avg_memory_usage", metrics.aggregated.avg_memory_usage);
+  jw_kv_uint(w, "min_memory_usage", metrics.aggregated.min_memory_usage);
+  jw_kv_uint(w, "max_memory_usage", metrics.aggregated.max_memory_usage);
+  jw_kv_uint(w, "p95_memory_usage", metrics.aggregated.p95_memory_usage);
+  jw_kv_uint(w, "total_disk_read", 0);
+  jw_kv_uint(w, "total_disk_write", 0);
+  jw_kv_uint(w, "sample_count", (uint64_t)metrics.aggregated.sample_count);
+  jw_object_end(w);
+
+#if defined(CONFIG_PROPLET_STAGE_TRACING)
+  uint64_t stage_cycles[TASK_TRACE_STAGE_COUNT];
+
+  if (task_trace_get(task_id, stage_cycles) == 0) {
+    jw_key(w, "stages");
+    jw_object_begin(w);
+    for (int i = 0; i < TASK_TRACE_STAGE_COUNT; i++) {
+      jw_kv_uint(w, task_trace_stage_name(i),
+                 k_cyc_to_us_floor64(stage_cycles[i]));
+    }
+    jw_object_end(w);
   }
+#endif
 
-  cJSON *root = cJSON_CreateObject();
-  if (root == NULL) {
-    LOG_ERR("Failed to create JSON for task metrics");
-    return;
-  }
+  jw_object_end(w);
+  return true;
+}
 
-  cJSON_AddStringToObject(root, "task_id", task_id);
-  cJSON_AddStringToObject(root, "proplet_id", proplet_id);
-  cJSON_AddNumberToObject(root, "timestamp", (double)k_uptime_get());
+void publish_task_metrics(const char *domain_id, const char *channel_id,
+                          const char *task_id, const char *proplet_id) {
+#if defined(CONFIG_PROPLET_CBOR_ENCODING)
+  task_metrics_t metrics;
 
-  cJSON *proc_metrics = cJSON_AddObjectToObject(root, "metrics");
-  if (proc_metrics != NULL) {
-    cJSON_AddNumberToObject(proc_metrics, "cpu_percent",
-                            metrics.current.cpu_percent);
-    cJSON_AddNumberToObject(proc_metrics, "memory_bytes",
-                            (double)metrics.current.memory_bytes);
-    cJSON_AddNumberToObject(proc_metrics, "memory_percent",
-                            metrics.current.memory_percent);
-    cJSON_AddNumberToObject(proc_metrics, "disk_read_bytes", 0.0);
-    cJSON_AddNumberToObject(proc_metrics, "disk_write_bytes", 0.0);
-    cJSON_AddNumberToObject(proc_metrics, "uptime_seconds",
-                            (double)metrics.current.uptime_seconds);
-    cJSON_AddNumberToObject(proc_metrics, "thread_count",
-                            (double)metrics.current.thread_count);
-    cJSON_AddNumberToObject(proc_metrics, "file_descriptor_count", 0.0);
-  }
-
-  cJSON *agg_metrics = cJSON_AddObjectToObject(root, "aggregated");
-  if (agg_metrics != NULL) {
-    cJSON_AddNumberToObject(agg_metrics, "avg_cpu_usage",
-                            metrics.aggregated.avg_cpu_usage);
-    cJSON_AddNumberToObject(agg_metrics, "max_cpu_usage",
-                            metrics.aggregated.max_cpu_usage);
-    cJSON_AddNumberToObject(agg_metrics, "avg_memory_usage",
-                            (double)metrics.aggregated.avg_memory_usage);
-    cJSON_AddNumberToObject(agg_metrics, "max_memory_usage",
-                            (double)metrics.aggregated.max_memory_usage);
-    cJSON_AddNumberToObject(agg_metrics, "total_disk_read", 0.0);
-    cJSON_AddNumberToObject(agg_metrics, "total_disk_write", 0.0);
-    cJSON_AddNumberToObject(agg_metrics, "sample_count",
-                            (double)metrics.aggregated.sample_count);
+  /* CBOR path encodes straight from the metrics struct, skipping cJSON */
+  if (task_monitor_get_metrics(task_id, &metrics) == 0) {
+    static uint8_t cbor_buf[1024];
+    size_t cbor_len = 0;
+
+    if (cbor_codec_encode_task_metrics(cbor_buf, sizeof(cbor_buf), &cbor_len,
+                                       &metrics, proplet_id,
+                                       k_uptime_get()) == 0) {
+      if (publish_raw(domain_id, channel_id, TASK_METRICS_TOPIC_TEMPLATE,
+                      cbor_buf, cbor_len) == 0) {
+        LOG_DBG("Published task metrics for: %s", task_id);
+      }
+      return;
+    }
+    LOG_WRN("CBOR task metrics encoding failed, falling back to JSON");
   }
+#endif
 
-  char *payload = cJSON_PrintUnformatted(root);
-  if (payload != NULL) {
-    if (publish(domain_id, channel_id, TASK_METRICS_TOPIC_TEMPLATE, payload) ==
-        0) {
-      LOG_DBG("Published task metrics for: %s", task_id);
-    }
-    cJSON_free(payload);
+  static char metrics_payload[1024];
+  struct json_writer w;
+
+  jw_init(&w, metrics_payload, sizeof(metrics_payload));
+  if (!write_task_metrics(&w, task_id, proplet_id)) {
+    return;
+  }
+  if (!jw_ok(&w)) {
+    LOG_ERR("Task metrics payload exceeds buffer for: %s", task_id);
+    return;
   }
 
-  cJSON_Delete(root);
+  if (publish(domain_id, channel_id, TASK_METRICS_TOPIC_TEMPLATE,
+              metrics_payload) == 0) {
+    LOG_DBG("Published task metrics for: %s", task_id);
+  }
 }
 
 void publish_active_task_metrics(const char *domain_id, const char *channel_id,
                                  const char *proplet_id) {
   char task_id[MAX_TASK_ID_LEN];
+  static char batch_payload[4096];
+  struct json_writer w;
+
+  /* Serialize all active tasks into one payload so the broker sees a single
+   * message per interval instead of one per task.
+   */
+  jw_init(&w, batch_payload, sizeof(batch_payload));
+  jw_object_begin(&w);
+  jw_kv_string(&w, "proplet_id", proplet_id);
+  jw_kv_uint(&w, "timestamp", (uint64_t)k_uptime_get());
+
+  jw_key(&w, "tasks");
+  jw_array_begin(&w);
+
+  int task_count = 0;
 
   for (int i = 0; task_monitor_get_active_task_id_at(i, task_id) == 0; i++) {
     task_monitor_sample(task_id);
-    publish_task_metrics(domain_id, channel_id, task_id, proplet_id);
+
+    if (write_task_metrics(&w, task_id, proplet_id)) {
+      task_count++;
+    }
+  }
+
+  jw_array_end(&w);
+  jw_object_end(&w);
+
+  if (task_count == 0) {
+    return;
+  }
+  if (!jw_ok(&w)) {
+    LOG_ERR("Batched task metrics payload exceeds buffer");
+    return;
+  }
+
+  if (publish(domain_id, channel_id, TASK_METRICS_TOPIC_TEMPLATE,
+              batch_payload) == 0) {
+    LOG_DBG("Published batched metrics for %d tasks", task_count);
   }
 }
 
 void mqtt_client_process(void) {
-  if (mqtt_connected) {
-    int ret =
-        poll_mqtt_socket(&client_ctx, mqtt_keepalive_time_left(&client_ctx));
-    if (ret > 0) {
+  mqtt_client_process_timeout(mqtt_keepalive_time_left(&client_ctx));
+}
+
+void mqtt_client_process_timeout(int timeout_ms) {
+  if (timeout_ms < 0) {
+    timeout_ms = 0;
+  }
+
+  if (!mqtt_connected) {
+    /* No socket to wait on; back off instead of spinning. Queued publishes
+     * are retained and flushed once the connection is re-established.
+     */
+    k_sleep(K_MSEC(timeout_ms));
+    return;
+  }
+
+  int keepalive_ms = mqtt_keepalive_time_left(&client_ctx);
+  if (keepalive_ms >= 0 && keepalive_ms < timeout_ms) {
+    timeout_ms = keepalive_ms;
+  }
+
+  /* Flush anything queued before parking in poll; the eventfd wakes the
+   * poll for messages enqueued while it is blocked.
+   */
+  publish_queue_drain();
+
+  int ret = poll_mqtt_socket(&client_ctx, timeout_ms, true);
+  if (ret > 0) {
+    if (fds[0].revents & ZSOCK_POLLIN) {
       mqtt_input(&client_ctx);
     }
-    mqtt_live(&client_ctx);
+    if (nfds > 1 && (fds[1].revents & ZSOCK_POLLIN)) {
+      eventfd_t unused;
+      (void)eventfd_read(g_publish_event_fd, &unused);
+    }
+  }
+  mqtt_live(&client_ctx);
+
+  publish_queue_drain();
+}
+
+int mqtt_client_wait_ready(int timeout_ms) {
+  int64_t deadline = k_uptime_get() + timeout_ms;
+
+  /* Event-based readiness: process MQTT traffic until the broker has
+   * acknowledged our subscriptions and the startup publishes (discovery)
+   * have been flushed, instead of sleeping for a fixed settle period.
+   */
+  while (true) {
+    bool queue_empty;
+
+    k_mutex_lock(&g_publish_queue_mutex, K_FOREVER);
+    queue_empty = (g_publish_queue_count == 0);
+    k_mutex_unlock(&g_publish_queue_mutex);
+
+    if (mqtt_connected && g_subscription_ready && queue_empty) {
+      return 0;
+    }
+
+    int64_t remaining = deadline - k_uptime_get();
+    if (remaining <= 0) {
+      return -ETIMEDOUT;
+    }
+
+    mqtt_client_process_timeout((int)MIN(remaining, 100));
   }
 }
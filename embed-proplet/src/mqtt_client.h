@@ -6,8 +6,6 @@
 #include <stdint.h>
 #include <zephyr/net/mqtt.h>
 
-#define PAYLOAD_BUFFER_SIZE 1024
-
 /* Default MQTT broker settings */
 #define MQTT_BROKER_HOSTNAME "10.42.0.1"
 #define MQTT_BROKER_PORT 1883
@@ -37,6 +35,9 @@ struct task {
   uint64_t results[MAX_RESULTS];
   size_t results_count;
 
+  /* Execution deadline in milliseconds; 0 means the Kconfig default */
+  uint32_t timeout_ms;
+
   char start_time[MAX_TIMESTAMP_LEN];
   char finish_time[MAX_TIMESTAMP_LEN];
   char created_at[MAX_TIMESTAMP_LEN];
@@ -54,8 +55,17 @@ struct task {
   bool is_fml_task;
 
   char proplet_id[MAX_ID_LEN];
-  char model_data[4096];
-  char dataset_data[4096];
+
+  /* Raw model/dataset bytes; point into the static host-data buffers owned
+   * by the MQTT module (CONFIG_PROPLET_HOST_DATA_BUF_SIZE each), so models
+   * are no longer capped at 4 KB of C string nor round-tripped through
+   * base64.
+   */
+  uint8_t *model_data;
+  size_t model_data_len;
+  uint8_t *dataset_data;
+  size_t dataset_data_len;
+
   char coordinator_url[MAX_URL_LEN];
   char model_registry_url[MAX_URL_LEN];
   char data_store_url[MAX_URL_LEN];
@@ -219,27 +229,55 @@ void publish_active_task_metrics(const char *domain_id, const char *channel_id,
  */
 void mqtt_client_process(void);
 
+/**
+ * @brief Process incoming MQTT messages, blocking until socket data arrives
+ * or the given timeout expires.
+ *
+ * Lets the caller sleep on the socket instead of polling, waking early when
+ * a message arrives and no later than the next scheduled deadline.
+ *
+ * @param timeout_ms Maximum time to wait for socket activity, in
+ * milliseconds. Clamped to the MQTT keepalive deadline.
+ */
+void mqtt_client_process_timeout(int timeout_ms);
+
+/**
+ * @brief Block until the proplet is ready to accept tasks.
+ *
+ * Processes MQTT traffic until the broker has acknowledged the
+ * subscriptions (or restored them with a persistent session) and all
+ * startup publishes have been flushed.
+ *
+ * @param timeout_ms Maximum time to wait, in milliseconds.
+ * @return 0 once ready, -ETIMEDOUT if the deadline passed first.
+ */
+int mqtt_client_wait_ready(int timeout_ms);
+
 /**
  * @brief Handle the start command received via MQTT.
  *
- * @param payload JSON payload for the start command.
+ * @param payload JSON payload for the start command (not owned, valid only
+ *                for the duration of the call).
+ * @param payload_len Length of the payload in bytes.
  */
-void handle_start_command(const char *payload);
+void handle_start_command(const char *payload, size_t payload_len);
 
 /**
  * @brief Handle the stop command received via MQTT.
  *
  * @param payload JSON payload for the stop command.
+ * @param payload_len Length of the payload in bytes.
  */
-void handle_stop_command(const char *payload);
+void handle_stop_command(const char *payload, size_t payload_len);
 
 /**
  * @brief Handle registry response that contains the base64-encoded WASM.
  *
  * @param payload JSON payload containing app_name + data (base64).
+ * @param payload_len Length of the payload in bytes.
  *
  * @return 0 on success, negative errno on failure.
  */
-int handle_registry_response(const char *payload);
+int handle_registry_response(const char *payload, size_t payload_len);
 
 #endif /* MQTT_CLIENT_H */
@@ -0,0 +1,188 @@
+#include "registry_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+
+LOG_MODULE_REGISTER(registry_cache);
+
+/* Images are stored under "registry/<slot>/..." in the settings backend.
+ * NVS caps individual item sizes well below a full module, so each image is
+ * split into fixed chunks ("d0".."dNN") alongside a metadata record that
+ * carries the app name, total size and a CRC for validation on load.
+ */
+#define CACHE_SLOTS 4
+#define CACHE_CHUNK_SIZE 1024
+#define CACHE_MAX_IMAGE (64 * 1024)
+#define CACHE_MAX_CHUNKS (CACHE_MAX_IMAGE / CACHE_CHUNK_SIZE)
+
+#define CACHE_APP_NAME_LEN 64
+
+struct cache_meta {
+  char app_name[CACHE_APP_NAME_LEN];
+  uint32_t crc;
+  uint32_t size;
+};
+
+static K_MUTEX_DEFINE(g_cache_mutex);
+
+static uint32_t hash_app_name(const char *app_name) {
+  uint32_t hash = 2166136261u;
+  for (const char *p = app_name; *p != '\0'; p++) {
+    hash ^= (uint8_t)*p;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+int registry_cache_init(void) {
+  /* The settings backend is shared with credentials.c; init is idempotent */
+  int rc = settings_subsys_init();
+  if (rc) {
+    LOG_ERR("settings_subsys_init failed: %d", rc);
+  }
+  return rc;
+}
+
+struct cache_load_ctx {
+  uint8_t *buf;
+  size_t buf_size;
+  struct cache_meta meta;
+  bool meta_ok;
+  size_t received;
+};
+
+static int cache_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+                         void *cb_arg, void *param) {
+  struct cache_load_ctx *ctx = param;
+
+  if (strcmp(key, "meta") == 0) {
+    if (len != sizeof(ctx->meta)) {
+      return 0;
+    }
+    if (read_cb(cb_arg, &ctx->meta, sizeof(ctx->meta)) ==
+        (ssize_t)sizeof(ctx->meta)) {
+      ctx->meta_ok = true;
+    }
+    return 0;
+  }
+
+  if (key[0] == 'd') {
+    int idx = atoi(key + 1);
+    if (idx < 0 || idx >= CACHE_MAX_CHUNKS) {
+      return 0;
+    }
+    size_t offset = (size_t)idx * CACHE_CHUNK_SIZE;
+    if (offset + len > ctx->buf_size) {
+      return 0;
+    }
+    ssize_t rc = read_cb(cb_arg, ctx->buf + offset, len);
+    if (rc > 0) {
+      ctx->received += (size_t)rc;
+    }
+  }
+
+  return 0;
+}
+
+int registry_cache_get(const char *app_name, uint8_t *buf, size_t buf_size,
+                       size_t *out_len) {
+  if (app_name == NULL || buf == NULL || out_len == NULL) {
+    return -EINVAL;
+  }
+
+  int slot = (int)(hash_app_name(app_name) % CACHE_SLOTS);
+  char subtree[24];
+  snprintf(subtree, sizeof(subtree), "registry/%d", slot);
+
+  struct cache_load_ctx ctx = {
+      .buf = buf,
+      .buf_size = buf_size,
+  };
+
+  k_mutex_lock(&g_cache_mutex, K_FOREVER);
+  int rc = settings_load_subtree_direct(subtree, cache_load_cb, &ctx);
+  k_mutex_unlock(&g_cache_mutex);
+
+  if (rc != 0) {
+    LOG_WRN("Failed to load cache subtree %s: %d", subtree, rc);
+    return rc;
+  }
+
+  if (!ctx.meta_ok ||
+      strncmp(ctx.meta.app_name, app_name, CACHE_APP_NAME_LEN) != 0) {
+    return -ENOENT;
+  }
+
+  if (ctx.meta.size > buf_size || ctx.received < ctx.meta.size) {
+    LOG_WRN("Cached image for %s incomplete (%zu of %u bytes)", app_name,
+            ctx.received, ctx.meta.size);
+    return -ENOENT;
+  }
+
+  if (crc32_ieee(buf, ctx.meta.size) != ctx.meta.crc) {
+    LOG_WRN("Cached image for %s failed CRC check, ignoring", app_name);
+    return -ENOENT;
+  }
+
+  *out_len = ctx.meta.size;
+  LOG_INF("Registry cache hit for %s (%u bytes, slot %d)", app_name,
+          ctx.meta.size, slot);
+  return 0;
+}
+
+int registry_cache_put(const char *app_name, const uint8_t *data, size_t len) {
+  if (app_name == NULL || data == NULL || len == 0) {
+    return -EINVAL;
+  }
+
+  if (len > CACHE_MAX_IMAGE) {
+    LOG_WRN("Image %s too large to cache (%zu > %d bytes)", app_name, len,
+            CACHE_MAX_IMAGE);
+    return -EFBIG;
+  }
+
+  int slot = (int)(hash_app_name(app_name) % CACHE_SLOTS);
+  char key[32];
+
+  struct cache_meta meta;
+  memset(&meta, 0, sizeof(meta));
+  strncpy(meta.app_name, app_name, sizeof(meta.app_name) - 1);
+  meta.crc = crc32_ieee(data, len);
+  meta.size = (uint32_t)len;
+
+  k_mutex_lock(&g_cache_mutex, K_FOREVER);
+
+  snprintf(key, sizeof(key), "registry/%d/meta", slot);
+  int rc = settings_save_one(key, &meta, sizeof(meta));
+  if (rc != 0) {
+    k_mutex_unlock(&g_cache_mutex);
+    LOG_ERR("Failed to save cache metadata for %s: %d", app_name, rc);
+    return rc;
+  }
+
+  for (size_t offset = 0, idx = 0; offset < len;
+       offset += CACHE_CHUNK_SIZE, idx++) {
+    size_t chunk = MIN(len - offset, (size_t)CACHE_CHUNK_SIZE);
+
+    snprintf(key, sizeof(key), "registry/%d/d%zu", slot, idx);
+    rc = settings_save_one(key, data + offset, chunk);
+    if (rc != 0) {
+      k_mutex_unlock(&g_cache_mutex);
+      LOG_ERR("Failed to save cache chunk %zu for %s: %d", idx, app_name, rc);
+      return rc;
+    }
+  }
+
+  k_mutex_unlock(&g_cache_mutex);
+
+  LOG_INF("Cached registry image %s (%zu bytes, slot %d)", app_name, len,
+          slot);
+  return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef REGISTRY_CACHE_H
+#define REGISTRY_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize the persistent registry cache.
+ *
+ * Binaries fetched from the registry are stored in flash (settings/NVS)
+ * keyed by app name, so repeat scheduling of a known image skips the
+ * network transfer entirely.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int registry_cache_init(void);
+
+/**
+ * @brief Look up a cached WASM image by app name.
+ *
+ * The stored CRC is verified over the loaded bytes before the entry is
+ * considered valid.
+ *
+ * @param app_name Registry app name / image reference.
+ * @param buf      Destination buffer for the image bytes.
+ * @param buf_size Capacity of the destination buffer.
+ * @param out_len  Set to the image size on success.
+ *
+ * @return 0 on hit, -ENOENT on miss or corruption, negative errno otherwise.
+ */
+int registry_cache_get(const char *app_name, uint8_t *buf, size_t buf_size,
+                       size_t *out_len);
+
+/**
+ * @brief Store a fetched WASM image in the persistent cache.
+ *
+ * An existing entry in the same cache slot is overwritten.
+ *
+ * @param app_name Registry app name / image reference.
+ * @param data     Image bytes.
+ * @param len      Image size in bytes.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int registry_cache_put(const char *app_name, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REGISTRY_CACHE_H */
@@ -1,10 +1,12 @@
 #include "task_monitor.h"
+#include "task_registry.h"
 
 #include <errno.h>
 #include <string.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 
 #if defined(CONFIG_CPU_LOAD)
 #include <zephyr/debug/cpu_load.h>
@@ -17,24 +19,99 @@ extern struct sys_heap _system_heap;
 
 LOG_MODULE_REGISTER(task_monitor);
 
+/* Recent samples kept per task for percentile estimation. Running
+ * min/avg/max are maintained incrementally over all samples; p95 is
+ * computed over this window.
+ */
+#define TASK_MONITOR_RING_SIZE 32
+
 typedef struct {
+  /* Seqlock guarding this slot: odd while a writer is mid-update. Writers
+   * (start/stop/sampler) still serialize on g_task_monitor_mutex, but
+   * readers copy a snapshot lock-free and retry on a torn read, so metrics
+   * queries never block the executor's start/stop path.
+   */
+  atomic_t seq;
+  uint32_t id_hash; /* FNV-1a of task_id, checked before strcmp */
   bool in_use;
   char task_id[MAX_TASK_ID_LEN];
   int64_t start_time_ms;
   process_metrics_t current;
   double cpu_sum;
+  double cpu_min;
   double cpu_max;
   uint64_t memory_sum;
+  uint64_t memory_min;
   uint64_t memory_max;
   int sample_count;
+  double cpu_ring[TASK_MONITOR_RING_SIZE];
+  uint32_t mem_ring[TASK_MONITOR_RING_SIZE];
+  int ring_head;
+  int ring_count;
 } monitored_task_t;
 
 static monitored_task_t g_monitored_tasks[MAX_MONITORED_TASKS];
+
+/* Hash-indexed task_id -> slot mapping; only the writer side uses it, the
+ * lock-free readers keep scanning snapshots with the id_hash precheck.
+ */
+TASK_REGISTRY_DEFINE(g_monitor_registry, MAX_MONITORED_TASKS);
 static bool g_initialized = false;
 static K_MUTEX_DEFINE(g_task_monitor_mutex);
 
-static int find_task_slot(const char *task_id);
-static int find_free_slot(void);
+
+static uint32_t hash_task_id(const char *task_id)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*task_id != '\0') {
+    hash ^= (uint8_t)*task_id++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static inline void slot_write_begin(monitored_task_t *task)
+{
+  atomic_inc(&task->seq);
+}
+
+static inline void slot_write_end(monitored_task_t *task)
+{
+  atomic_inc(&task->seq);
+}
+
+/* Copies a consistent snapshot of a slot without taking the writer mutex.
+ * Returns true when the snapshot describes an active task. Torn reads back
+ * off with a sleep after a few tries: a higher-priority reader spinning
+ * here would otherwise never let a preempted lower-priority writer finish
+ * its window on a single core.
+ */
+static bool read_task_snapshot(int slot, monitored_task_t *out)
+{
+  const monitored_task_t *task = &g_monitored_tasks[slot];
+  int tries = 0;
+
+  for (;;) {
+    if (++tries > 3) {
+      k_msleep(1);
+    }
+
+    atomic_val_t s1 = atomic_get(&task->seq);
+    if (s1 & 1) {
+      continue;
+    }
+
+    memcpy(out, task, sizeof(*out));
+
+    if (atomic_get(&task->seq) == s1) {
+      break;
+    }
+  }
+
+  return out->in_use;
+}
+
 static void collect_current_metrics(process_metrics_t *metrics,
                                     int64_t start_time_ms);
 
@@ -54,6 +131,121 @@ static int get_thread_count(void)
 }
 #endif
 
+/* Records one sample into a task's aggregates and sample ring. Caller must
+ * hold g_task_monitor_mutex.
+ */
+static void record_sample_locked(monitored_task_t *task)
+{
+  collect_current_metrics(&task->current, task->start_time_ms);
+
+  double cpu = task->current.cpu_percent;
+  uint32_t mem = task->current.memory_bytes;
+
+  if (task->sample_count == 0) {
+    task->cpu_min = cpu;
+    task->cpu_max = cpu;
+    task->memory_min = mem;
+    task->memory_max = mem;
+  } else {
+    if (cpu < task->cpu_min) {
+      task->cpu_min = cpu;
+    }
+    if (cpu > task->cpu_max) {
+      task->cpu_max = cpu;
+    }
+    if (mem < task->memory_min) {
+      task->memory_min = mem;
+    }
+    if (mem > task->memory_max) {
+      task->memory_max = mem;
+    }
+  }
+
+  task->cpu_sum += cpu;
+  task->memory_sum += mem;
+  task->sample_count++;
+
+  task->cpu_ring[task->ring_head] = cpu;
+  task->mem_ring[task->ring_head] = mem;
+  task->ring_head = (task->ring_head + 1) % TASK_MONITOR_RING_SIZE;
+  if (task->ring_count < TASK_MONITOR_RING_SIZE) {
+    task->ring_count++;
+  }
+}
+
+/* Nearest-rank p95 over the sample ring (at most TASK_MONITOR_RING_SIZE
+ * values, so the insertion sorts stay cheap). Operates on a snapshot, so no
+ * lock is required.
+ */
+static void ring_p95(const monitored_task_t *task, double *cpu_p95,
+                            uint64_t *mem_p95)
+{
+  double cpu_sorted[TASK_MONITOR_RING_SIZE];
+  uint32_t mem_sorted[TASK_MONITOR_RING_SIZE];
+  int n = task->ring_count;
+
+  if (n == 0) {
+    *cpu_p95 = 0.0;
+    *mem_p95 = 0;
+    return;
+  }
+
+  memcpy(cpu_sorted, task->cpu_ring, n * sizeof(cpu_sorted[0]));
+  memcpy(mem_sorted, task->mem_ring, n * sizeof(mem_sorted[0]));
+
+  for (int i = 1; i < n; i++) {
+    double cv = cpu_sorted[i];
+    uint32_t mv = mem_sorted[i];
+    int j;
+
+    for (j = i - 1; j >= 0 && cpu_sorted[j] > cv; j--) {
+      cpu_sorted[j + 1] = cpu_sorted[j];
+    }
+    cpu_sorted[j + 1] = cv;
+
+    for (j = i - 1; j >= 0 && mem_sorted[j] > mv; j--) {
+      mem_sorted[j + 1] = mem_sorted[j];
+    }
+    mem_sorted[j + 1] = mv;
+  }
+
+  int idx = ((n * 95) + 99) / 100 - 1;
+  if (idx < 0) {
+    idx = 0;
+  }
+  if (idx >= n) {
+    idx = n - 1;
+  }
+
+  *cpu_p95 = cpu_sorted[idx];
+  *mem_p95 = mem_sorted[idx];
+}
+
+static void sampler_work_handler(struct k_work *work)
+{
+  ARG_UNUSED(work);
+
+  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
+  for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
+    if (g_monitored_tasks[i].in_use) {
+      slot_write_begin(&g_monitored_tasks[i]);
+      record_sample_locked(&g_monitored_tasks[i]);
+      slot_write_end(&g_monitored_tasks[i]);
+    }
+  }
+  k_mutex_unlock(&g_task_monitor_mutex);
+}
+
+K_WORK_DEFINE(g_sampler_work, sampler_work_handler);
+
+static void sampler_timer_expire(struct k_timer *timer)
+{
+  ARG_UNUSED(timer);
+  k_work_submit(&g_sampler_work);
+}
+
+K_TIMER_DEFINE(g_sampler_timer, sampler_timer_expire, NULL);
+
 int task_monitor_init(void)
 {
   if (g_initialized) {
@@ -61,9 +253,15 @@ int task_monitor_init(void)
   }
 
   memset(g_monitored_tasks, 0, sizeof(g_monitored_tasks));
+  task_registry_init(&g_monitor_registry);
   g_initialized = true;
 
-  LOG_INF("Task monitor initialized (max tasks: %d)", MAX_MONITORED_TASKS);
+  k_timer_start(&g_sampler_timer,
+                K_MSEC(CONFIG_PROPLET_MONITOR_SAMPLE_INTERVAL_MS),
+                K_MSEC(CONFIG_PROPLET_MONITOR_SAMPLE_INTERVAL_MS));
+
+  LOG_INF("Task monitor initialized (max tasks: %d, sample interval: %d ms)",
+          MAX_MONITORED_TASKS, CONFIG_PROPLET_MONITOR_SAMPLE_INTERVAL_MS);
   return 0;
 }
 
@@ -81,14 +279,12 @@ int task_monitor_start(const char *task_id)
 
   k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
 
-  int existing = find_task_slot(task_id);
-  int slot;
-  if (existing >= 0) {
+  int slot = task_registry_find(&g_monitor_registry, task_id);
+  if (slot >= 0) {
     LOG_WRN("Task %s already being monitored, clearing and restarting",
             task_id);
-    slot = existing;
   } else {
-    slot = find_free_slot();
+    slot = task_registry_insert(&g_monitor_registry, task_id);
     if (slot < 0) {
       LOG_ERR("No free monitoring slots (max %d)", MAX_MONITORED_TASKS);
       k_mutex_unlock(&g_task_monitor_mutex);
@@ -97,22 +293,24 @@ int task_monitor_start(const char *task_id)
   }
 
   monitored_task_t *task = &g_monitored_tasks[slot];
+
+  slot_write_begin(task);
+
+  atomic_val_t seq = atomic_get(&task->seq);
   memset(task, 0, sizeof(*task));
+  atomic_set(&task->seq, seq);
 
   strncpy(task->task_id, task_id, MAX_TASK_ID_LEN - 1);
   task->task_id[MAX_TASK_ID_LEN - 1] = '\0';
+  task->id_hash = hash_task_id(task->task_id);
   task->start_time_ms = k_uptime_get();
 
-  collect_current_metrics(&task->current, task->start_time_ms);
-
-  task->cpu_sum = task->current.cpu_percent;
-  task->cpu_max = task->current.cpu_percent;
-  task->memory_sum = task->current.memory_bytes;
-  task->memory_max = task->current.memory_bytes;
-  task->sample_count = 1;
+  record_sample_locked(task);
 
   task->in_use = true;
 
+  slot_write_end(task);
+
   k_mutex_unlock(&g_task_monitor_mutex);
 
   LOG_INF("Started monitoring task: %s", task_id);
@@ -127,7 +325,7 @@ int task_monitor_sample(const char *task_id)
 
   k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
 
-  int slot = find_task_slot(task_id);
+  int slot = task_registry_find(&g_monitor_registry, task_id);
   if (slot < 0) {
     LOG_WRN("Task %s not found for sampling", task_id);
     k_mutex_unlock(&g_task_monitor_mutex);
@@ -136,19 +334,9 @@ int task_monitor_sample(const char *task_id)
 
   monitored_task_t *task = &g_monitored_tasks[slot];
 
-  collect_current_metrics(&task->current, task->start_time_ms);
-
-  task->cpu_sum += task->current.cpu_percent;
-  if (task->current.cpu_percent > task->cpu_max) {
-    task->cpu_max = task->current.cpu_percent;
-  }
-
-  task->memory_sum += task->current.memory_bytes;
-  if (task->current.memory_bytes > task->memory_max) {
-    task->memory_max = task->current.memory_bytes;
-  }
-
-  task->sample_count++;
+  slot_write_begin(task);
+  record_sample_locked(task);
+  slot_write_end(task);
 
   k_mutex_unlock(&g_task_monitor_mutex);
 
@@ -167,7 +355,7 @@ int task_monitor_stop(const char *task_id)
 
   k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
 
-  int slot = find_task_slot(task_id);
+  int slot = task_registry_find(&g_monitor_registry, task_id);
   if (slot < 0) {
     LOG_WRN("Task %s not found to stop", task_id);
     k_mutex_unlock(&g_task_monitor_mutex);
@@ -176,18 +364,12 @@ int task_monitor_stop(const char *task_id)
 
   monitored_task_t *task = &g_monitored_tasks[slot];
 
-  collect_current_metrics(&task->current, task->start_time_ms);
-  task->cpu_sum += task->current.cpu_percent;
-  task->memory_sum += task->current.memory_bytes;
-  if (task->current.cpu_percent > task->cpu_max) {
-    task->cpu_max = task->current.cpu_percent;
-  }
-  if (task->current.memory_bytes > task->memory_max) {
-    task->memory_max = task->current.memory_bytes;
-  }
-  task->sample_count++;
-
+  slot_write_begin(task);
+  record_sample_locked(task);
   task->in_use = false;
+  slot_write_end(task);
+
+  (void)task_registry_remove(&g_monitor_registry, task_id);
 
   k_mutex_unlock(&g_task_monitor_mutex);
 
@@ -202,33 +384,44 @@ int task_monitor_get_metrics(const char *task_id, task_metrics_t *metrics)
     return -EINVAL;
   }
 
-  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
+  /* Lock-free read: take a seqlock snapshot of the matching slot and
+   * derive everything from the local copy.
+   */
+  monitored_task_t snap;
+  uint32_t hash = hash_task_id(task_id);
+  bool found = false;
 
-  int slot = find_task_slot(task_id);
-  if (slot < 0) {
-    k_mutex_unlock(&g_task_monitor_mutex);
-    return -ENOENT;
+  for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
+    if (read_task_snapshot(i, &snap) && snap.id_hash == hash &&
+        strcmp(snap.task_id, task_id) == 0) {
+      found = true;
+      break;
+    }
   }
 
-  monitored_task_t *task = &g_monitored_tasks[slot];
+  if (!found) {
+    return -ENOENT;
+  }
 
   memset(metrics, 0, sizeof(*metrics));
-  strncpy(metrics->task_id, task->task_id, MAX_TASK_ID_LEN - 1);
-  metrics->active = task->in_use;
-  metrics->start_time_ms = task->start_time_ms;
-
-  memcpy(&metrics->current, &task->current, sizeof(process_metrics_t));
-
-  if (task->sample_count > 0) {
-    metrics->aggregated.avg_cpu_usage = task->cpu_sum / task->sample_count;
-    metrics->aggregated.max_cpu_usage = task->cpu_max;
-    metrics->aggregated.avg_memory_usage = task->memory_sum / task->sample_count;
-    metrics->aggregated.max_memory_usage = task->memory_max;
-    metrics->aggregated.sample_count = task->sample_count;
+  strncpy(metrics->task_id, snap.task_id, MAX_TASK_ID_LEN - 1);
+  metrics->active = snap.in_use;
+  metrics->start_time_ms = snap.start_time_ms;
+
+  memcpy(&metrics->current, &snap.current, sizeof(process_metrics_t));
+
+  if (snap.sample_count > 0) {
+    metrics->aggregated.avg_cpu_usage = snap.cpu_sum / snap.sample_count;
+    metrics->aggregated.min_cpu_usage = snap.cpu_min;
+    metrics->aggregated.max_cpu_usage = snap.cpu_max;
+    metrics->aggregated.avg_memory_usage = snap.memory_sum / snap.sample_count;
+    metrics->aggregated.min_memory_usage = snap.memory_min;
+    metrics->aggregated.max_memory_usage = snap.memory_max;
+    metrics->aggregated.sample_count = snap.sample_count;
+    ring_p95(&snap, &metrics->aggregated.p95_cpu_usage,
+             &metrics->aggregated.p95_memory_usage);
   }
 
-  k_mutex_unlock(&g_task_monitor_mutex);
-
   return 0;
 }
 
@@ -238,13 +431,16 @@ bool task_monitor_is_active(const char *task_id)
     return false;
   }
 
-  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
-
-  int slot = find_task_slot(task_id);
+  monitored_task_t snap;
+  uint32_t hash = hash_task_id(task_id);
 
-  k_mutex_unlock(&g_task_monitor_mutex);
-
-  return (slot >= 0);
+  for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
+    if (read_task_snapshot(i, &snap) && snap.id_hash == hash &&
+        strcmp(snap.task_id, task_id) == 0) {
+      return true;
+    }
+  }
+  return false;
 }
 
 int task_monitor_get_active_task_id(char *task_id_out)
@@ -253,18 +449,16 @@ int task_monitor_get_active_task_id(char *task_id_out)
     return -EINVAL;
   }
 
-  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
+  monitored_task_t snap;
 
   for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
-    if (g_monitored_tasks[i].in_use) {
-      strncpy(task_id_out, g_monitored_tasks[i].task_id, MAX_TASK_ID_LEN - 1);
+    if (read_task_snapshot(i, &snap)) {
+      strncpy(task_id_out, snap.task_id, MAX_TASK_ID_LEN - 1);
       task_id_out[MAX_TASK_ID_LEN - 1] = '\0';
-      k_mutex_unlock(&g_task_monitor_mutex);
       return 0;
     }
   }
 
-  k_mutex_unlock(&g_task_monitor_mutex);
   return -ENOENT;
 }
 
@@ -274,17 +468,15 @@ int task_monitor_get_active_count(void)
     return 0;
   }
 
-  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
-
+  monitored_task_t snap;
   int count = 0;
+
   for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
-    if (g_monitored_tasks[i].in_use) {
+    if (read_task_snapshot(i, &snap)) {
       count++;
     }
   }
 
-  k_mutex_unlock(&g_task_monitor_mutex);
-
   return count;
 }
 
@@ -294,45 +486,23 @@ int task_monitor_get_active_task_id_at(int index, char *task_id_out)
     return -EINVAL;
   }
 
-  k_mutex_lock(&g_task_monitor_mutex, K_FOREVER);
-
+  monitored_task_t snap;
   int active_index = 0;
+
   for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
-    if (g_monitored_tasks[i].in_use) {
+    if (read_task_snapshot(i, &snap)) {
       if (active_index == index) {
-        strncpy(task_id_out, g_monitored_tasks[i].task_id, MAX_TASK_ID_LEN - 1);
+        strncpy(task_id_out, snap.task_id, MAX_TASK_ID_LEN - 1);
         task_id_out[MAX_TASK_ID_LEN - 1] = '\0';
-        k_mutex_unlock(&g_task_monitor_mutex);
         return 0;
       }
       active_index++;
     }
   }
 
-  k_mutex_unlock(&g_task_monitor_mutex);
   return -ENOENT;
 }
 
-static int find_task_slot(const char *task_id)
-{
-  for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
-    if (g_monitored_tasks[i].in_use &&
-        strcmp(g_monitored_tasks[i].task_id, task_id) == 0) {
-      return i;
-    }
-  }
-  return -1;
-}
-
-static int find_free_slot(void)
-{
-  for (int i = 0; i < MAX_MONITORED_TASKS; i++) {
-    if (!g_monitored_tasks[i].in_use) {
-      return i;
-    }
-  }
-  return -1;
-}
 
 static void collect_current_metrics(process_metrics_t *metrics,
                                     int64_t start_time_ms)
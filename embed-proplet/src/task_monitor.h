@@ -8,7 +8,7 @@
 extern "C" {
 #endif
 
-#define MAX_MONITORED_TASKS 4
+#define MAX_MONITORED_TASKS CONFIG_PROPLET_MAX_TASKS
 #define MAX_TASK_ID_LEN 64
 
 /**
@@ -27,9 +27,13 @@ typedef struct {
  */
 typedef struct {
     double avg_cpu_usage;
+    double min_cpu_usage;
     double max_cpu_usage;
+    double p95_cpu_usage;
     uint64_t avg_memory_usage;
+    uint64_t min_memory_usage;
     uint64_t max_memory_usage;
+    uint64_t p95_memory_usage;
     int sample_count;
 } aggregated_metrics_t;
 
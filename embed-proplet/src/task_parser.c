@@ -0,0 +1,365 @@
+#include "task_parser.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/sys/util.h>
+
+/* A span is a view into the caller's payload: no bytes are copied until a
+ * key matches a known task field.
+ */
+struct json_span {
+  const char *ptr;
+  size_t len;
+};
+
+static bool span_eq(const struct json_span *s, const char *lit) {
+  size_t n = strlen(lit);
+
+  return s->len == n && memcmp(s->ptr, lit, n) == 0;
+}
+
+static void span_copy(char *dst, size_t dst_size, const struct json_span *s) {
+  size_t n = MIN(s->len, dst_size - 1);
+
+  memcpy(dst, s->ptr, n);
+  dst[n] = '\0';
+}
+
+static const char *skip_ws(const char *p, const char *end) {
+  while (p < end &&
+         (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+    p++;
+  }
+  return p;
+}
+
+/* Parses a JSON string starting at the opening quote. The returned span
+ * covers the raw bytes between the quotes; escapes are skipped but not
+ * decoded. Returns the position after the closing quote, or NULL.
+ */
+static const char *parse_string(const char *p, const char *end,
+                                struct json_span *out) {
+  if (p >= end || *p != '"') {
+    return NULL;
+  }
+  p++;
+  out->ptr = p;
+
+  while (p < end) {
+    if (*p == '\\') {
+      p += 2;
+      continue;
+    }
+    if (*p == '"') {
+      out->len = (size_t)(p - out->ptr);
+      return p + 1;
+    }
+    p++;
+  }
+  return NULL;
+}
+
+/* Skips one JSON value of any type, tracking object/array nesting and
+ * string state so that unknown fields of arbitrary shape are passed over.
+ * Returns the position after the value, or NULL on malformed input.
+ */
+static const char *skip_value(const char *p, const char *end) {
+  p = skip_ws(p, end);
+  if (p >= end) {
+    return NULL;
+  }
+
+  if (*p == '"') {
+    struct json_span ignored;
+    return parse_string(p, end, &ignored);
+  }
+
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+
+    while (p < end) {
+      if (*p == '"') {
+        struct json_span ignored;
+        p = parse_string(p, end, &ignored);
+        if (p == NULL) {
+          return NULL;
+        }
+        continue;
+      }
+      if (*p == '{' || *p == '[') {
+        depth++;
+      } else if (*p == '}' || *p == ']') {
+        depth--;
+        if (depth == 0) {
+          return p + 1;
+        }
+      }
+      p++;
+    }
+    return NULL;
+  }
+
+  /* Number, true, false or null: scan to the next delimiter */
+  while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+         *p != '\t' && *p != '\n' && *p != '\r') {
+    p++;
+  }
+  return p;
+}
+
+/* Parses a non-negative JSON number as uint64, truncating any fractional
+ * part, matching the (uint64_t)valuedouble conversion used elsewhere.
+ */
+static const char *parse_u64(const char *p, const char *end, uint64_t *out) {
+  uint64_t value = 0;
+  bool have_digit = false;
+
+  while (p < end && *p >= '0' && *p <= '9') {
+    value = value * 10 + (uint64_t)(*p - '0');
+    have_digit = true;
+    p++;
+  }
+  if (!have_digit) {
+    return NULL;
+  }
+
+  if (p < end && *p == '.') {
+    p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      p++;
+    }
+  }
+
+  *out = value;
+  return p;
+}
+
+static const char *parse_inputs(const char *p, const char *end,
+                                struct task *t) {
+  p = skip_ws(p, end);
+  if (p >= end || *p != '[') {
+    return NULL;
+  }
+  p = skip_ws(p + 1, end);
+
+  if (p < end && *p == ']') {
+    return p + 1;
+  }
+
+  while (p < end) {
+    uint64_t value = 0;
+
+    p = parse_u64(p, end, &value);
+    if (p == NULL) {
+      return NULL;
+    }
+    if (t->inputs_count < MAX_INPUTS) {
+      t->inputs[t->inputs_count++] = value;
+    }
+
+    p = skip_ws(p, end);
+    if (p < end && *p == ',') {
+      p = skip_ws(p + 1, end);
+      continue;
+    }
+    if (p < end && *p == ']') {
+      return p + 1;
+    }
+    return NULL;
+  }
+  return NULL;
+}
+
+static void apply_env_defaults(struct task *t) {
+  if (t->coordinator_url[0] == '\0') {
+    strncpy(t->coordinator_url, "http://coordinator-http:8080",
+            sizeof(t->coordinator_url) - 1);
+    t->coordinator_url[sizeof(t->coordinator_url) - 1] = '\0';
+  }
+  if (t->model_registry_url[0] == '\0') {
+    strncpy(t->model_registry_url, "http://model-registry:8081",
+            sizeof(t->model_registry_url) - 1);
+    t->model_registry_url[sizeof(t->model_registry_url) - 1] = '\0';
+  }
+  if (t->data_store_url[0] == '\0') {
+    strncpy(t->data_store_url, "http://local-data-store:8083",
+            sizeof(t->data_store_url) - 1);
+    t->data_store_url[sizeof(t->data_store_url) - 1] = '\0';
+  }
+  if (t->fl_format[0] == '\0') {
+    strncpy(t->fl_format, "f32-delta", MAX_NAME_LEN - 1);
+    t->fl_format[MAX_NAME_LEN - 1] = '\0';
+  }
+  if (t->fl_num_samples_str[0] == '\0') {
+    strncpy(t->fl_num_samples_str, "1", sizeof(t->fl_num_samples_str) - 1);
+    t->fl_num_samples_str[sizeof(t->fl_num_samples_str) - 1] = '\0';
+  }
+}
+
+static const char *parse_env(const char *p, const char *end, struct task *t) {
+  p = skip_ws(p, end);
+  if (p >= end || *p != '{') {
+    return NULL;
+  }
+  p = skip_ws(p + 1, end);
+
+  if (p < end && *p == '}') {
+    apply_env_defaults(t);
+    return p + 1;
+  }
+
+  while (p < end) {
+    struct json_span key;
+    struct json_span value;
+
+    p = parse_string(p, end, &key);
+    if (p == NULL) {
+      return NULL;
+    }
+    p = skip_ws(p, end);
+    if (p >= end || *p != ':') {
+      return NULL;
+    }
+    p = skip_ws(p + 1, end);
+
+    if (p < end && *p == '"') {
+      p = parse_string(p, end, &value);
+      if (p == NULL) {
+        return NULL;
+      }
+
+      if (span_eq(&key, "ROUND_ID")) {
+        span_copy(t->round_id, sizeof(t->round_id), &value);
+        t->is_fml_task = true;
+      } else if (span_eq(&key, "MODEL_URI")) {
+        span_copy(t->model_uri, sizeof(t->model_uri), &value);
+      } else if (span_eq(&key, "HYPERPARAMS")) {
+        span_copy(t->hyperparams, sizeof(t->hyperparams), &value);
+      } else if (span_eq(&key, "MANAGER_COORDINATOR_URL")) {
+        span_copy(t->coordinator_url, sizeof(t->coordinator_url), &value);
+      } else if (span_eq(&key, "MODEL_REGISTRY_URL")) {
+        span_copy(t->model_registry_url, sizeof(t->model_registry_url),
+                  &value);
+      } else if (span_eq(&key, "DATA_STORE_URL")) {
+        span_copy(t->data_store_url, sizeof(t->data_store_url), &value);
+      } else if (span_eq(&key, "FL_ROUND_ID")) {
+        span_copy(t->fl_round_id_str, sizeof(t->fl_round_id_str), &value);
+      } else if (span_eq(&key, "FL_FORMAT")) {
+        span_copy(t->fl_format, MAX_NAME_LEN, &value);
+      } else if (span_eq(&key, "FL_NUM_SAMPLES")) {
+        span_copy(t->fl_num_samples_str, sizeof(t->fl_num_samples_str),
+                  &value);
+      }
+    } else {
+      p = skip_value(p, end);
+      if (p == NULL) {
+        return NULL;
+      }
+    }
+
+    p = skip_ws(p, end);
+    if (p < end && *p == ',') {
+      p = skip_ws(p + 1, end);
+      continue;
+    }
+    if (p < end && *p == '}') {
+      apply_env_defaults(t);
+      return p + 1;
+    }
+    return NULL;
+  }
+  return NULL;
+}
+
+int task_parser_parse(const char *payload, size_t payload_len,
+                      struct task *t) {
+  const char *p = payload;
+  const char *end = payload + payload_len;
+
+  p = skip_ws(p, end);
+  if (p >= end || *p != '{') {
+    return -EINVAL;
+  }
+  p = skip_ws(p + 1, end);
+
+  while (p < end && *p != '}') {
+    struct json_span key;
+    struct json_span value;
+
+    p = parse_string(p, end, &key);
+    if (p == NULL) {
+      return -EINVAL;
+    }
+    p = skip_ws(p, end);
+    if (p >= end || *p != ':') {
+      return -EINVAL;
+    }
+    p = skip_ws(p + 1, end);
+    if (p >= end) {
+      return -EINVAL;
+    }
+
+    if (span_eq(&key, "inputs")) {
+      p = parse_inputs(p, end, t);
+    } else if (span_eq(&key, "timeout_ms")) {
+      uint64_t timeout = 0;
+
+      p = parse_u64(p, end, &timeout);
+      if (p != NULL) {
+        t->timeout_ms = (uint32_t)timeout;
+      }
+    } else if (span_eq(&key, "env")) {
+      p = parse_env(p, end, t);
+    } else if (*p == '"' && span_eq(&key, "id")) {
+      p = parse_string(p, end, &value);
+      if (p != NULL) {
+        span_copy(t->id, MAX_ID_LEN, &value);
+      }
+    } else if (*p == '"' && span_eq(&key, "name")) {
+      p = parse_string(p, end, &value);
+      if (p != NULL) {
+        span_copy(t->name, MAX_NAME_LEN, &value);
+      }
+    } else if (*p == '"' && span_eq(&key, "image_url")) {
+      p = parse_string(p, end, &value);
+      if (p != NULL) {
+        span_copy(t->image_url, MAX_URL_LEN, &value);
+      }
+    } else if (*p == '"' && span_eq(&key, "file")) {
+      p = parse_string(p, end, &value);
+      if (p != NULL) {
+        span_copy(t->file, MAX_BASE64_LEN, &value);
+      }
+    } else if (*p == '"' && span_eq(&key, "mode")) {
+      p = parse_string(p, end, &value);
+      if (p != NULL) {
+        span_copy(t->mode, MAX_NAME_LEN, &value);
+      }
+    } else {
+      p = skip_value(p, end);
+    }
+
+    if (p == NULL) {
+      return -EINVAL;
+    }
+
+    p = skip_ws(p, end);
+    if (p < end && *p == ',') {
+      p = skip_ws(p + 1, end);
+      continue;
+    }
+    break;
+  }
+
+  if (p >= end || *p != '}') {
+    return -EINVAL;
+  }
+
+  if (t->id[0] == '\0' || t->name[0] == '\0') {
+    return -EINVAL;
+  }
+
+  return 0;
+}
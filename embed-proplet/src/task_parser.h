@@ -0,0 +1,39 @@
+#ifndef TASK_PARSER_H
+#define TASK_PARSER_H
+
+#include "mqtt_client.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parse a start-command JSON payload directly into a task.
+ *
+ * In-place, zero-allocation parser for the known task schema (id, name,
+ * image_url, file, inputs, mode, timeout_ms, env). Field values are copied straight from
+ * the payload into @p t without building a node tree, which keeps the
+ * command-to-execution hot path off the system heap. cJSON remains in use
+ * for low-rate messages (stop commands, registry responses, discovery).
+ *
+ * String escape sequences are not decoded; task IDs, URLs and base64 data
+ * never contain them.
+ *
+ * @param payload     JSON payload (not owned, not required to be
+ *                    NUL-terminated).
+ * @param payload_len Length of the payload in bytes.
+ * @param t           Task to populate. Must be zero-initialized by the
+ *                    caller; defaults for env-derived fields are applied
+ *                    when an "env" object is present.
+ *
+ * @return 0 on success, -EINVAL on malformed JSON or missing id/name.
+ */
+int task_parser_parse(const char *payload, size_t payload_len, struct task *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_PARSER_H */
@@ -0,0 +1,139 @@
+#include "task_registry.h"
+
+#include <errno.h>
+#include <string.h>
+
+enum bucket_state {
+  BUCKET_EMPTY = 0,
+  BUCKET_USED,
+  BUCKET_TOMBSTONE,
+};
+
+static uint32_t hash_task_id(const char *task_id) {
+  uint32_t hash = 2166136261u;
+
+  while (*task_id != '\0') {
+    hash ^= (uint8_t)*task_id++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/* Linear probe for the bucket holding task_id. Probing stops at the first
+ * empty bucket: tombstones keep probe chains intact across removals.
+ */
+static int bucket_lookup(struct task_registry *reg, const char *task_id,
+                         uint32_t hash) {
+  for (uint16_t i = 0; i < reg->bucket_count; i++) {
+    uint16_t b = (uint16_t)((hash + i) % reg->bucket_count);
+    struct task_registry_bucket *bucket = &reg->buckets[b];
+
+    if (bucket->state == BUCKET_EMPTY) {
+      return -ENOENT;
+    }
+    if (bucket->state == BUCKET_USED && bucket->hash == hash &&
+        strncmp(bucket->id, task_id, TASK_REGISTRY_ID_LEN) == 0) {
+      return b;
+    }
+  }
+  return -ENOENT;
+}
+
+/* First insertable bucket (empty or tombstone) along the probe sequence */
+static int bucket_find_free(struct task_registry *reg, uint32_t hash) {
+  for (uint16_t i = 0; i < reg->bucket_count; i++) {
+    uint16_t b = (uint16_t)((hash + i) % reg->bucket_count);
+
+    if (reg->buckets[b].state != BUCKET_USED) {
+      return b;
+    }
+  }
+  return -ENOSPC;
+}
+
+void task_registry_init(struct task_registry *reg) {
+  memset(reg->buckets, 0, reg->bucket_count * sizeof(reg->buckets[0]));
+  for (uint16_t i = 0; i < reg->capacity; i++) {
+    reg->free_list[i] = (uint16_t)(reg->capacity - 1 - i);
+  }
+  reg->free_count = reg->capacity;
+  k_mutex_init(&reg->lock);
+}
+
+int task_registry_insert(struct task_registry *reg, const char *task_id) {
+  if (task_id == NULL || task_id[0] == '\0') {
+    return -EINVAL;
+  }
+
+  uint32_t hash = hash_task_id(task_id);
+
+  k_mutex_lock(&reg->lock, K_FOREVER);
+
+  if (bucket_lookup(reg, task_id, hash) >= 0) {
+    k_mutex_unlock(&reg->lock);
+    return -EEXIST;
+  }
+  if (reg->free_count == 0) {
+    k_mutex_unlock(&reg->lock);
+    return -ENOSPC;
+  }
+
+  int b = bucket_find_free(reg, hash);
+  if (b < 0) {
+    k_mutex_unlock(&reg->lock);
+    return -ENOSPC;
+  }
+
+  uint16_t index = reg->free_list[--reg->free_count];
+  struct task_registry_bucket *bucket = &reg->buckets[b];
+
+  bucket->state = BUCKET_USED;
+  bucket->index = index;
+  bucket->hash = hash;
+  strncpy(bucket->id, task_id, TASK_REGISTRY_ID_LEN - 1);
+  bucket->id[TASK_REGISTRY_ID_LEN - 1] = '\0';
+
+  k_mutex_unlock(&reg->lock);
+  return index;
+}
+
+int task_registry_find(struct task_registry *reg, const char *task_id) {
+  if (task_id == NULL || task_id[0] == '\0') {
+    return -EINVAL;
+  }
+
+  uint32_t hash = hash_task_id(task_id);
+
+  k_mutex_lock(&reg->lock, K_FOREVER);
+  int b = bucket_lookup(reg, task_id, hash);
+  int index = (b >= 0) ? reg->buckets[b].index : -ENOENT;
+  k_mutex_unlock(&reg->lock);
+
+  return index;
+}
+
+int task_registry_remove(struct task_registry *reg, const char *task_id) {
+  if (task_id == NULL || task_id[0] == '\0') {
+    return -EINVAL;
+  }
+
+  uint32_t hash = hash_task_id(task_id);
+
+  k_mutex_lock(&reg->lock, K_FOREVER);
+
+  int b = bucket_lookup(reg, task_id, hash);
+  if (b < 0) {
+    k_mutex_unlock(&reg->lock);
+    return -ENOENT;
+  }
+
+  struct task_registry_bucket *bucket = &reg->buckets[b];
+  int index = bucket->index;
+
+  bucket->state = BUCKET_TOMBSTONE;
+  memset(bucket->id, 0, sizeof(bucket->id));
+  reg->free_list[reg->free_count++] = (uint16_t)index;
+
+  k_mutex_unlock(&reg->lock);
+  return index;
+}
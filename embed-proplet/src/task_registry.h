@@ -0,0 +1,86 @@
+#ifndef TASK_REGISTRY_H
+#define TASK_REGISTRY_H
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_REGISTRY_ID_LEN 64
+
+/**
+ * Shared task-id index: an open-addressed hash table mapping task IDs to
+ * data-slot indices, plus a free list handing out the slots themselves.
+ * Replaces the linear strcmp scans over fixed slot arrays in the WASM app
+ * table and the task monitor. Callers own the data arrays; the registry
+ * only manages which slot an ID maps to.
+ */
+struct task_registry_bucket {
+  uint8_t state; /* empty / used / tombstone */
+  uint16_t index;
+  uint32_t hash;
+  char id[TASK_REGISTRY_ID_LEN];
+};
+
+struct task_registry {
+  struct task_registry_bucket *buckets;
+  uint16_t bucket_count;
+  uint16_t *free_list;
+  uint16_t free_count;
+  uint16_t capacity;
+  struct k_mutex lock;
+};
+
+/**
+ * @brief Declare static storage for a registry of the given capacity.
+ *
+ * Buckets are sized at twice the capacity so the probe sequences stay
+ * short (load factor <= 0.5).
+ */
+#define TASK_REGISTRY_DEFINE(name, cap)                                        \
+  static struct task_registry_bucket name##_buckets[(cap) * 2];                \
+  static uint16_t name##_free_list[cap];                                       \
+  static struct task_registry name = {                                         \
+      .buckets = name##_buckets,                                               \
+      .bucket_count = (cap) * 2,                                               \
+      .free_list = name##_free_list,                                           \
+      .capacity = (cap),                                                       \
+  }
+
+/**
+ * @brief Reset the registry: all buckets empty, all slots free.
+ *
+ * Must be called once before any other operation.
+ */
+void task_registry_init(struct task_registry *reg);
+
+/**
+ * @brief Map a task ID to a fresh data slot.
+ *
+ * @return The allocated slot index, -EEXIST if the ID is already
+ *         registered, -ENOSPC when no slot is free.
+ */
+int task_registry_insert(struct task_registry *reg, const char *task_id);
+
+/**
+ * @brief Look up the data slot for a task ID.
+ *
+ * @return The slot index, or -ENOENT.
+ */
+int task_registry_find(struct task_registry *reg, const char *task_id);
+
+/**
+ * @brief Unmap a task ID and return its slot to the free list.
+ *
+ * @return The released slot index, or -ENOENT.
+ */
+int task_registry_remove(struct task_registry *reg, const char *task_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_REGISTRY_H */
@@ -0,0 +1,120 @@
+#include "task_trace.h"
+
+#if defined(CONFIG_PROPLET_STAGE_TRACING)
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "task_monitor.h"
+
+/* A small ring of records guarded by a mutex: the MQTT thread accumulates
+ * parse/decode stages for a new task while the executor thread is still
+ * accumulating load/call stages for queued ones, so records sized to the
+ * executor queue depth keep concurrent pipelines from clobbering each
+ * other. Cycles accumulate per stage because some stages run more than
+ * once per task (e.g. decode of file + inputs).
+ */
+#define TASK_TRACE_RECORDS 4
+
+struct trace_record {
+  char task_id[MAX_TASK_ID_LEN];
+  uint64_t stage_cycles[TASK_TRACE_STAGE_COUNT];
+  uint32_t age; /* begin order; lowest is evicted first */
+};
+
+static struct trace_record g_trace_records[TASK_TRACE_RECORDS];
+static uint32_t g_trace_age;
+static K_MUTEX_DEFINE(g_trace_mutex);
+
+static struct trace_record *find_record(const char *task_id)
+{
+  for (int i = 0; i < TASK_TRACE_RECORDS; i++) {
+    if (g_trace_records[i].task_id[0] != '\0' &&
+        strncmp(g_trace_records[i].task_id, task_id,
+                sizeof(g_trace_records[i].task_id)) == 0) {
+      return &g_trace_records[i];
+    }
+  }
+  return NULL;
+}
+
+static const char *const g_stage_names[TASK_TRACE_STAGE_COUNT] = {
+  [TASK_TRACE_STAGE_PARSE] = "parse_us",
+  [TASK_TRACE_STAGE_DECODE] = "decode_us",
+  [TASK_TRACE_STAGE_LOAD] = "load_us",
+  [TASK_TRACE_STAGE_INSTANTIATE] = "instantiate_us",
+  [TASK_TRACE_STAGE_CALL] = "call_us",
+  [TASK_TRACE_STAGE_PUBLISH] = "publish_us",
+};
+
+void task_trace_begin(const char *task_id)
+{
+  if (task_id == NULL) {
+    return;
+  }
+
+  k_mutex_lock(&g_trace_mutex, K_FOREVER);
+
+  struct trace_record *rec = find_record(task_id);
+  if (rec == NULL) {
+    rec = &g_trace_records[0];
+    for (int i = 1; i < TASK_TRACE_RECORDS; i++) {
+      if (g_trace_records[i].age < rec->age) {
+        rec = &g_trace_records[i];
+      }
+    }
+  }
+
+  memset(rec, 0, sizeof(*rec));
+  strncpy(rec->task_id, task_id, sizeof(rec->task_id) - 1);
+  rec->age = ++g_trace_age;
+
+  k_mutex_unlock(&g_trace_mutex);
+}
+
+void task_trace_stage(const char *task_id, enum task_trace_stage stage,
+                      uint64_t start_cycles)
+{
+  uint64_t elapsed = k_cycle_get_64() - start_cycles;
+
+  if (task_id == NULL || stage >= TASK_TRACE_STAGE_COUNT) {
+    return;
+  }
+
+  k_mutex_lock(&g_trace_mutex, K_FOREVER);
+
+  struct trace_record *rec = find_record(task_id);
+  if (rec != NULL) {
+    rec->stage_cycles[stage] += elapsed;
+  }
+
+  k_mutex_unlock(&g_trace_mutex);
+}
+
+int task_trace_get(const char *task_id,
+                   uint64_t cycles_out[TASK_TRACE_STAGE_COUNT])
+{
+  if (task_id == NULL || cycles_out == NULL) {
+    return -EINVAL;
+  }
+
+  k_mutex_lock(&g_trace_mutex, K_FOREVER);
+
+  struct trace_record *rec = find_record(task_id);
+  if (rec == NULL) {
+    k_mutex_unlock(&g_trace_mutex);
+    return -ENOENT;
+  }
+  memcpy(cycles_out, rec->stage_cycles, sizeof(rec->stage_cycles));
+
+  k_mutex_unlock(&g_trace_mutex);
+  return 0;
+}
+
+const char *task_trace_stage_name(enum task_trace_stage stage)
+{
+  return (stage < TASK_TRACE_STAGE_COUNT) ? g_stage_names[stage] : "";
+}
+
+#endif /* CONFIG_PROPLET_STAGE_TRACING */
@@ -0,0 +1,76 @@
+#ifndef TASK_TRACE_H
+#define TASK_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Pipeline stages measured between MQTT receive and result publish.
+ */
+enum task_trace_stage {
+  TASK_TRACE_STAGE_PARSE,
+  TASK_TRACE_STAGE_DECODE,
+  TASK_TRACE_STAGE_LOAD,
+  TASK_TRACE_STAGE_INSTANTIATE,
+  TASK_TRACE_STAGE_CALL,
+  TASK_TRACE_STAGE_PUBLISH,
+  TASK_TRACE_STAGE_COUNT,
+};
+
+#if defined(CONFIG_PROPLET_STAGE_TRACING)
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Allocate (or reset) a trace record for a task.
+ *
+ * Records live in a small ring sized to the executor queue depth, so
+ * traces for queued tasks survive new tasks being started; the oldest
+ * record is evicted when the ring is full.
+ */
+void task_trace_begin(const char *task_id);
+
+/**
+ * @brief Accumulate elapsed cycles since start_cycles into a stage of the
+ * task's record. Dropped silently if no record exists for the task.
+ */
+void task_trace_stage(const char *task_id, enum task_trace_stage stage,
+                      uint64_t start_cycles);
+
+/**
+ * @brief Copy the accumulated stage cycles for a task.
+ *
+ * @return 0 on success, -ENOENT if the trace belongs to another task.
+ */
+int task_trace_get(const char *task_id,
+                   uint64_t cycles_out[TASK_TRACE_STAGE_COUNT]);
+
+/**
+ * @brief JSON key for a stage (e.g. "parse_us").
+ */
+const char *task_trace_stage_name(enum task_trace_stage stage);
+
+/* Declares a cycle-accurate timestamp for a stage boundary. Expands to
+ * nothing when tracing is disabled, so traced paths carry zero overhead.
+ */
+#define TASK_TRACE_MARK(ts) uint64_t ts = k_cycle_get_64()
+#define TASK_TRACE_BEGIN(task_id) task_trace_begin(task_id)
+#define TASK_TRACE_STAGE(task_id, stage, ts)                                   \
+  task_trace_stage((task_id), (stage), (ts))
+
+#else /* !CONFIG_PROPLET_STAGE_TRACING */
+
+#define TASK_TRACE_MARK(ts)
+#define TASK_TRACE_BEGIN(task_id)
+#define TASK_TRACE_STAGE(task_id, stage, ts)
+
+#endif /* CONFIG_PROPLET_STAGE_TRACING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_TRACE_H */
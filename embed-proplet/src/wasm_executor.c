@@ -0,0 +1,121 @@
+#include "wasm_executor.h"
+#include "mqtt_client.h"
+#include "wasm_handler.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(wasm_executor);
+
+#define EXECUTOR_STACK_SIZE 8192
+#define EXECUTOR_PRIORITY 5
+
+/* One queued execution. The executor owns wasm_data and frees it after the
+ * task finishes (the module cache in wasm_handler.c keeps its own copy of
+ * anything it retains). Host data travels in the job as well: the model and
+ * dataset pointers reference the static buffers owned by the MQTT module,
+ * which are only rewritten when a new task arrives, so the executor never
+ * has to touch g_current_task.
+ */
+struct executor_job {
+  char task_id[MAX_ID_LEN];
+  uint8_t *wasm_data;
+  size_t wasm_size;
+  uint64_t inputs[MAX_INPUTS];
+  size_t inputs_count;
+  uint32_t timeout_ms;
+  char proplet_id[MAX_ID_LEN];
+  const uint8_t *model_data;
+  size_t model_data_len;
+  const uint8_t *dataset_data;
+  size_t dataset_data_len;
+};
+
+K_MSGQ_DEFINE(g_executor_queue, sizeof(struct executor_job),
+              WASM_EXECUTOR_QUEUE_DEPTH, 8);
+
+int wasm_executor_submit(const struct task *t, const uint8_t *wasm_data,
+                         size_t wasm_size)
+{
+  struct executor_job job;
+
+  memset(&job, 0, sizeof(job));
+  strncpy(job.task_id, t->id, sizeof(job.task_id) - 1);
+  job.task_id[sizeof(job.task_id) - 1] = '\0';
+  job.timeout_ms =
+      (t->timeout_ms > 0) ? t->timeout_ms : CONFIG_PROPLET_TASK_TIMEOUT_MS;
+
+  job.wasm_data = malloc(wasm_size);
+  if (job.wasm_data == NULL) {
+    LOG_ERR("Failed to copy %zu-byte module for task %s", wasm_size, t->id);
+    return -ENOMEM;
+  }
+  memcpy(job.wasm_data, wasm_data, wasm_size);
+  job.wasm_size = wasm_size;
+
+  job.inputs_count =
+      (t->inputs_count > MAX_INPUTS) ? MAX_INPUTS : t->inputs_count;
+  for (size_t i = 0; i < job.inputs_count; i++) {
+    job.inputs[i] = t->inputs[i];
+  }
+
+  strncpy(job.proplet_id, t->proplet_id, sizeof(job.proplet_id) - 1);
+  job.proplet_id[sizeof(job.proplet_id) - 1] = '\0';
+  if (t->model_data_fetched && t->model_data != NULL) {
+    job.model_data = t->model_data;
+    job.model_data_len = t->model_data_len;
+  }
+  if (t->dataset_data_fetched && t->dataset_data != NULL) {
+    job.dataset_data = t->dataset_data;
+    job.dataset_data_len = t->dataset_data_len;
+  }
+
+  int ret = k_msgq_put(&g_executor_queue, &job, K_NO_WAIT);
+
+  if (ret != 0) {
+    LOG_WRN("Executor queue full (%d pending), rejecting task %s",
+            wasm_executor_pending(), t->id);
+    free(job.wasm_data);
+    return -EAGAIN;
+  }
+
+  LOG_INF("Task %s queued for execution (%d pending)", t->id,
+          wasm_executor_pending());
+  return 0;
+}
+
+int wasm_executor_pending(void)
+{
+  return (int)k_msgq_num_used_get(&g_executor_queue);
+}
+
+static void executor_thread_fn(void *p1, void *p2, void *p3)
+{
+  ARG_UNUSED(p1);
+  ARG_UNUSED(p2);
+  ARG_UNUSED(p3);
+
+  struct executor_job job;
+
+  while (1) {
+    k_msgq_get(&g_executor_queue, &job, K_FOREVER);
+
+    LOG_INF("Executing queued task %s (%zu bytes)", job.task_id,
+            job.wasm_size);
+
+    wasm_handler_set_host_data(job.proplet_id, job.model_data,
+                               job.model_data_len, job.dataset_data,
+                               job.dataset_data_len);
+    execute_wasm_module(job.task_id, job.wasm_data, job.wasm_size, job.inputs,
+                        job.inputs_count, job.timeout_ms);
+
+    free(job.wasm_data);
+  }
+}
+
+K_THREAD_DEFINE(wasm_executor_tid, EXECUTOR_STACK_SIZE, executor_thread_fn,
+                NULL, NULL, NULL, EXECUTOR_PRIORITY, 0, 0);
@@ -0,0 +1,46 @@
+#ifndef WASM_EXECUTOR_H
+#define WASM_EXECUTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WASM_EXECUTOR_QUEUE_DEPTH 4
+
+struct task;
+
+/**
+ * @brief Submit a WASM task for asynchronous execution.
+ *
+ * Copies the module bytes and snapshots everything the executor needs from
+ * the task (id, inputs, timeout, proplet id, fetched model/dataset buffers)
+ * into the queued job, so the MQTT event path returns immediately and the
+ * executor never reads the MQTT thread's task state concurrently.
+ *
+ * @param t          Task to run; id, inputs, timeout and host-data fields
+ *                   are copied into the job (timeout 0 falls back to
+ *                   CONFIG_PROPLET_TASK_TIMEOUT_MS).
+ * @param wasm_data  Pointer to the Wasm file data in memory (copied).
+ * @param wasm_size  Size of the Wasm file data in bytes.
+ *
+ * @return 0 on success, -EAGAIN if the submission queue is full,
+ *         -ENOMEM if the module bytes could not be copied.
+ */
+int wasm_executor_submit(const struct task *t, const uint8_t *wasm_data,
+                         size_t wasm_size);
+
+/**
+ * @brief Number of tasks currently queued but not yet executing.
+ *
+ * @return Queue depth in use (0..WASM_EXECUTOR_QUEUE_DEPTH).
+ */
+int wasm_executor_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WASM_EXECUTOR_H */
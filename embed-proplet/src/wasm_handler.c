@@ -1,85 +1,622 @@
 #include "wasm_handler.h"
 #include "mqtt_client.h"
 #include "task_monitor.h"
+#include "task_registry.h"
+#include "task_trace.h"
 #include <logging/log.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <wasm_export.h>
 
 LOG_MODULE_REGISTER(wasm_handler);
 
-#define MAX_WASM_APPS 10
+#define MAX_WASM_APPS CONFIG_PROPLET_MAX_TASKS
 #define MAX_ID_LEN 64
 #define MAX_INPUTS 16
 #define MAX_RESULTS 16
 
+/* Loaded-module cache: repeat dispatch of the same image skips
+ * wasm_runtime_load()/validate and goes straight to instantiation. Entries
+ * are keyed by an FNV-1a hash of the module bytes and evicted LRU, bounded
+ * by both slot count and a byte budget so the cache cannot starve the heap.
+ */
+#define MODULE_CACHE_SLOTS 4
+#define MODULE_CACHE_MAX_BYTES (64 * 1024)
+
+/* Warm module_inst/exec_env pairs kept per cached module so repeat tasks
+ * skip wasm_runtime_instantiate() + wasm_runtime_create_exec_env() and pay
+ * only for the function call itself. Used pairs are never parked: the
+ * release path destroys them and refills the slot with a pristine pair, so
+ * no task ever sees another task's linear memory or globals.
+ */
+#define INSTANCE_POOL_SIZE 2
+
+#define WASM_INST_STACK_SIZE (16 * 1024)
+#define WASM_INST_HEAP_SIZE (16 * 1024)
+
+typedef struct
+{
+  bool occupied; /* slot holds a warm pair */
+  bool busy;     /* pair currently lent to an execution */
+  wasm_module_inst_t module_inst;
+  wasm_exec_env_t exec_env;
+} pooled_instance_t;
+
+typedef struct
+{
+  bool in_use;
+  uint32_t hash;
+  size_t size;
+  uint8_t *data; /* owned copy; WAMR references it while loaded */
+  wasm_module_t module;
+  int refcount;
+  int64_t last_used_ms;
+  pooled_instance_t instances[INSTANCE_POOL_SIZE];
+} module_cache_entry_t;
+
+static module_cache_entry_t g_module_cache[MODULE_CACHE_SLOTS];
+static size_t g_module_cache_bytes;
+static K_MUTEX_DEFINE(g_module_cache_mutex);
+
 typedef struct
 {
   bool in_use;
+  bool stop_requested;
   char id[MAX_ID_LEN];
   wasm_module_t module;
   wasm_module_inst_t module_inst;
+  wasm_exec_env_t exec_env;
 } wasm_app_t;
 
 static wasm_app_t g_wasm_apps[MAX_WASM_APPS];
 static K_MUTEX_DEFINE(g_wasm_apps_mutex);
 
+/* Hash-indexed task_id -> slot mapping shared with the task monitor's
+ * registry component; replaces the linear in_use scans.
+ */
+TASK_REGISTRY_DEFINE(g_app_registry, MAX_WASM_APPS);
+
 static bool g_wamr_initialized = false;
 
 static void maybe_init_wamr_runtime(void);
-static int find_free_slot(void);
-static int find_app_by_id(const char *task_id);
 
-static bool write_string_to_wasm_memory(wasm_exec_env_t exec_env, const char *str,
-                                         uint32_t *ret_offset, uint32_t *ret_len) {
-  wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
-  if (!module_inst || !str) {
+static void maybe_init_app_registry(void)
+{
+  static bool initialized;
+
+  k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
+  if (!initialized)
+  {
+    task_registry_init(&g_app_registry);
+    initialized = true;
+  }
+  k_mutex_unlock(&g_wasm_apps_mutex);
+}
+
+static uint32_t hash_wasm_bytes(const uint8_t *data, size_t size)
+{
+  /* FNV-1a: cheap enough to run over full images on every dispatch */
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static module_cache_entry_t *module_cache_lookup(uint32_t hash, size_t size,
+                                                 const uint8_t *data)
+{
+  for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+  {
+    module_cache_entry_t *e = &g_module_cache[i];
+    if (e->in_use && e->hash == hash && e->size == size &&
+        memcmp(e->data, data, size) == 0)
+    {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+static bool module_cache_evict_lru(void)
+{
+  int victim = -1;
+
+  for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+  {
+    module_cache_entry_t *e = &g_module_cache[i];
+    if (!e->in_use || e->refcount > 0)
+    {
+      continue;
+    }
+    if (victim < 0 ||
+        e->last_used_ms < g_module_cache[victim].last_used_ms)
+    {
+      victim = i;
+    }
+  }
+
+  if (victim < 0)
+  {
     return false;
   }
-  
-  size_t str_len = strlen(str);
-  uint32_t str_buf_offset = wasm_runtime_module_malloc(module_inst, str_len + 1, (void**)NULL);
-  if (str_buf_offset == 0) {
-    LOG_ERR("Failed to allocate WASM memory for string");
+
+  module_cache_entry_t *e = &g_module_cache[victim];
+  LOG_INF("Evicting cached module (hash=0x%08x, %zu bytes)", e->hash, e->size);
+  for (int i = 0; i < INSTANCE_POOL_SIZE; i++)
+  {
+    pooled_instance_t *p = &e->instances[i];
+    if (p->occupied && !p->busy)
+    {
+      wasm_runtime_destroy_exec_env(p->exec_env);
+      wasm_runtime_deinstantiate(p->module_inst);
+      memset(p, 0, sizeof(*p));
+    }
+  }
+  wasm_runtime_unload(e->module);
+  free(e->data);
+  g_module_cache_bytes -= e->size;
+  memset(e, 0, sizeof(*e));
+  return true;
+}
+
+/* wasm_runtime_load() accepts both formats when WAMR is built with AOT
+ * support; the magic bytes tell them apart. Interpreter bytecode starts
+ * with "\0asm", AOT artifacts compiled for this target with "\0aot".
+ */
+static const char *wasm_image_format(const uint8_t *data, size_t size)
+{
+  if (size >= 4 && data[0] == 0x00)
+  {
+    if (data[1] == 'a' && data[2] == 's' && data[3] == 'm')
+    {
+      return "wasm";
+    }
+    if (data[1] == 'a' && data[2] == 'o' && data[3] == 't')
+    {
+      return "aot";
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Returns a loaded module for the given bytes, reusing a cached handle when
+ * the same image was dispatched before. The returned module must be handed
+ * back with module_cache_release() instead of wasm_runtime_unload().
+ */
+static wasm_module_t module_cache_acquire(const uint8_t *wasm_data,
+                                          size_t wasm_size, char *error_buf,
+                                          size_t error_buf_size)
+{
+  uint32_t hash = hash_wasm_bytes(wasm_data, wasm_size);
+
+  k_mutex_lock(&g_module_cache_mutex, K_FOREVER);
+
+  module_cache_entry_t *e = module_cache_lookup(hash, wasm_size, wasm_data);
+  if (e != NULL)
+  {
+    e->refcount++;
+    e->last_used_ms = k_uptime_get();
+    wasm_module_t module = e->module;
+    k_mutex_unlock(&g_module_cache_mutex);
+    LOG_INF("Module cache hit (hash=0x%08x), skipping load", hash);
+    return module;
+  }
+
+  /* Make room: a free slot plus byte budget for the new image */
+  int slot = -1;
+  for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+  {
+    if (!g_module_cache[i].in_use)
+    {
+      slot = i;
+      break;
+    }
+  }
+  while ((slot < 0 ||
+          g_module_cache_bytes + wasm_size > MODULE_CACHE_MAX_BYTES) &&
+         module_cache_evict_lru())
+  {
+    if (slot < 0)
+    {
+      for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+      {
+        if (!g_module_cache[i].in_use)
+        {
+          slot = i;
+          break;
+        }
+      }
+    }
+  }
+
+  uint8_t *copy = NULL;
+  if (slot >= 0 && g_module_cache_bytes + wasm_size <= MODULE_CACHE_MAX_BYTES)
+  {
+    copy = malloc(wasm_size);
+  }
+
+  if (copy == NULL)
+  {
+    /* Cache full of in-flight modules, byte budget exceeded (eviction can
+     * stall on referenced entries), or no heap left: load uncached from
+     * the caller's buffer as before.
+     */
+    k_mutex_unlock(&g_module_cache_mutex);
+    return wasm_runtime_load(wasm_data, wasm_size, error_buf, error_buf_size);
+  }
+
+  memcpy(copy, wasm_data, wasm_size);
+
+  wasm_module_t module =
+      wasm_runtime_load(copy, wasm_size, error_buf, error_buf_size);
+  if (module == NULL)
+  {
+    free(copy);
+    k_mutex_unlock(&g_module_cache_mutex);
+    return NULL;
+  }
+
+  e = &g_module_cache[slot];
+  e->in_use = true;
+  e->hash = hash;
+  e->size = wasm_size;
+  e->data = copy;
+  e->module = module;
+  e->refcount = 1;
+  e->last_used_ms = k_uptime_get();
+  g_module_cache_bytes += wasm_size;
+
+  k_mutex_unlock(&g_module_cache_mutex);
+  LOG_INF("Module cached (hash=0x%08x, %zu bytes, cache now %zu bytes)", hash,
+          wasm_size, g_module_cache_bytes);
+  return module;
+}
+
+static void module_cache_release(wasm_module_t module)
+{
+  k_mutex_lock(&g_module_cache_mutex, K_FOREVER);
+
+  for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+  {
+    module_cache_entry_t *e = &g_module_cache[i];
+    if (e->in_use && e->module == module)
+    {
+      if (e->refcount > 0)
+      {
+        e->refcount--;
+      }
+      k_mutex_unlock(&g_module_cache_mutex);
+      return;
+    }
+  }
+
+  k_mutex_unlock(&g_module_cache_mutex);
+
+  /* Not cached (loaded via the fallback path): unload immediately */
+  wasm_runtime_unload(module);
+}
+
+static module_cache_entry_t *module_cache_find_by_module(wasm_module_t module)
+{
+  for (int i = 0; i < MODULE_CACHE_SLOTS; i++)
+  {
+    if (g_module_cache[i].in_use && g_module_cache[i].module == module)
+    {
+      return &g_module_cache[i];
+    }
+  }
+  return NULL;
+}
+
+static bool instance_pool_acquire(wasm_module_t module,
+                                  wasm_module_inst_t *module_inst,
+                                  wasm_exec_env_t *exec_env)
+{
+  k_mutex_lock(&g_module_cache_mutex, K_FOREVER);
+
+  module_cache_entry_t *e = module_cache_find_by_module(module);
+  if (e != NULL)
+  {
+    for (int i = 0; i < INSTANCE_POOL_SIZE; i++)
+    {
+      pooled_instance_t *p = &e->instances[i];
+      if (p->occupied && !p->busy)
+      {
+        p->busy = true;
+        *module_inst = p->module_inst;
+        *exec_env = p->exec_env;
+        k_mutex_unlock(&g_module_cache_mutex);
+        LOG_INF("Reusing warm instance for module hash=0x%08x", e->hash);
+        return true;
+      }
+    }
+  }
+
+  k_mutex_unlock(&g_module_cache_mutex);
+  return false;
+}
+
+/*
+ * Hands an instance/exec-env pair back after an execution. A used pair is
+ * always destroyed — its linear memory and globals carry the previous
+ * task's state, which must never leak into the next one. For cached
+ * modules the freed pool slot is immediately refilled with a freshly
+ * instantiated pair, so the next task still skips both load and
+ * instantiation while starting from pristine state.
+ */
+static void instance_pool_release(wasm_module_t module,
+                                  wasm_module_inst_t module_inst,
+                                  wasm_exec_env_t exec_env)
+{
+  k_mutex_lock(&g_module_cache_mutex, K_FOREVER);
+
+  module_cache_entry_t *e = module_cache_find_by_module(module);
+  pooled_instance_t *slot = NULL;
+
+  if (e != NULL)
+  {
+    for (int i = 0; i < INSTANCE_POOL_SIZE; i++)
+    {
+      pooled_instance_t *p = &e->instances[i];
+      if (p->occupied && p->module_inst == module_inst)
+      {
+        memset(p, 0, sizeof(*p));
+        slot = p;
+        break;
+      }
+    }
+    if (slot == NULL)
+    {
+      for (int i = 0; i < INSTANCE_POOL_SIZE; i++)
+      {
+        if (!e->instances[i].occupied)
+        {
+          slot = &e->instances[i];
+          break;
+        }
+      }
+    }
+  }
+
+  if (exec_env != NULL)
+  {
+    wasm_runtime_destroy_exec_env(exec_env);
+  }
+  wasm_runtime_deinstantiate(module_inst);
+
+  if (slot != NULL)
+  {
+    char error_buf[128];
+    wasm_module_inst_t fresh =
+        wasm_runtime_instantiate(module, WASM_INST_STACK_SIZE,
+                                 WASM_INST_HEAP_SIZE, error_buf,
+                                 sizeof(error_buf));
+    if (fresh != NULL)
+    {
+      wasm_exec_env_t fresh_env =
+          wasm_runtime_create_exec_env(fresh, WASM_INST_STACK_SIZE);
+      if (fresh_env != NULL)
+      {
+        slot->occupied = true;
+        slot->busy = false;
+        slot->module_inst = fresh;
+        slot->exec_env = fresh_env;
+      }
+      else
+      {
+        wasm_runtime_deinstantiate(fresh);
+        LOG_WRN("Could not refill warm-instance slot (no exec env)");
+      }
+    }
+    else
+    {
+      LOG_WRN("Could not refill warm-instance slot: %s", error_buf);
+    }
+  }
+
+  k_mutex_unlock(&g_module_cache_mutex);
+}
+
+/* Host data (proplet id, model, dataset) is written into the instance's
+ * linear memory once per execution; the accessor natives hand back the
+ * stored offset+length instead of allocating and copying on every call.
+ * Executions are serialized on the executor thread, so one staging area is
+ * enough.
+ */
+typedef struct
+{
+  uint32_t offset;
+  uint32_t len;
+} staged_str_t;
+
+static struct
+{
+  wasm_module_inst_t inst;
+  staged_str_t proplet_id;
+  staged_str_t model_data;
+  staged_str_t dataset_data;
+} g_staged_host_data;
+
+/* Writes len raw bytes plus a trailing NUL into the instance's linear
+ * memory; the reported length excludes the terminator, so modules can treat
+ * the region as either bytes or a C string.
+ */
+static bool stage_host_bytes(wasm_module_inst_t module_inst,
+                             const uint8_t *data, size_t len,
+                             staged_str_t *out)
+{
+  void *native = NULL;
+  uint32_t offset = wasm_runtime_module_malloc(module_inst, len + 1, &native);
+
+  if (offset == 0 || native == NULL)
+  {
+    LOG_ERR("Failed to stage %zu-byte host buffer in WASM memory", len);
+    out->offset = 0;
+    out->len = 0;
     return false;
   }
-  
-  char *str_buf = wasm_runtime_addr_app_to_native(module_inst, str_buf_offset);
-  if (!str_buf) {
-    wasm_runtime_module_free(module_inst, str_buf_offset);
+
+  memcpy(native, data, len);
+  ((uint8_t *)native)[len] = '\0';
+  out->offset = offset;
+  out->len = len;
+  return true;
+}
+
+/* Per-job host data handed over by the executor thread before each
+ * execution; replaces direct reads of the MQTT thread's g_current_task.
+ */
+static struct
+{
+  char proplet_id[MAX_ID_LEN];
+  const uint8_t *model_data;
+  size_t model_len;
+  const uint8_t *dataset_data;
+  size_t dataset_len;
+} g_task_host_data;
+
+void wasm_handler_set_host_data(const char *proplet_id,
+                                const uint8_t *model_data, size_t model_len,
+                                const uint8_t *dataset_data,
+                                size_t dataset_len)
+{
+  memset(&g_task_host_data, 0, sizeof(g_task_host_data));
+  if (proplet_id != NULL)
+  {
+    strncpy(g_task_host_data.proplet_id, proplet_id, MAX_ID_LEN - 1);
+  }
+  g_task_host_data.model_data = model_data;
+  g_task_host_data.model_len = model_len;
+  g_task_host_data.dataset_data = dataset_data;
+  g_task_host_data.dataset_len = dataset_len;
+}
+
+static void stage_host_data(wasm_module_inst_t module_inst)
+{
+  const char *proplet_id = g_task_host_data.proplet_id;
+  const uint8_t *model_data = (const uint8_t *)"";
+  size_t model_len = 0;
+  const uint8_t *dataset_data = (const uint8_t *)"";
+  size_t dataset_len = 0;
+
+  if (g_task_host_data.model_data != NULL)
+  {
+    model_data = g_task_host_data.model_data;
+    model_len = g_task_host_data.model_len;
+  }
+  if (g_task_host_data.dataset_data != NULL)
+  {
+    dataset_data = g_task_host_data.dataset_data;
+    dataset_len = g_task_host_data.dataset_len;
+  }
+
+  g_staged_host_data.inst = module_inst;
+  stage_host_bytes(module_inst, (const uint8_t *)proplet_id,
+                   strlen(proplet_id), &g_staged_host_data.proplet_id);
+  stage_host_bytes(module_inst, model_data, model_len,
+                   &g_staged_host_data.model_data);
+  stage_host_bytes(module_inst, dataset_data, dataset_len,
+                   &g_staged_host_data.dataset_data);
+}
+
+/* Returns staged allocations to the instance heap so pooled instances do
+ * not accumulate stale host data across reuses.
+ */
+static void unstage_host_data(void)
+{
+  wasm_module_inst_t inst = g_staged_host_data.inst;
+
+  if (inst == NULL)
+  {
+    return;
+  }
+  if (g_staged_host_data.proplet_id.offset != 0)
+  {
+    wasm_runtime_module_free(inst, g_staged_host_data.proplet_id.offset);
+  }
+  if (g_staged_host_data.model_data.offset != 0)
+  {
+    wasm_runtime_module_free(inst, g_staged_host_data.model_data.offset);
+  }
+  if (g_staged_host_data.dataset_data.offset != 0)
+  {
+    wasm_runtime_module_free(inst, g_staged_host_data.dataset_data.offset);
+  }
+  memset(&g_staged_host_data, 0, sizeof(g_staged_host_data));
+}
+
+static bool staged_lookup(wasm_exec_env_t exec_env, const staged_str_t *s,
+                          uint32_t *ret_offset, uint32_t *ret_len)
+{
+  wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+
+  if (module_inst == NULL || module_inst != g_staged_host_data.inst ||
+      s->offset == 0)
+  {
     return false;
   }
-  
-  memcpy(str_buf, str, str_len + 1);
-  *ret_offset = str_buf_offset;
-  *ret_len = str_len;
+  *ret_offset = s->offset;
+  *ret_len = s->len;
   return true;
 }
 
 static bool get_proplet_id_wrapper(wasm_exec_env_t exec_env,
                                     uint32_t *ret_offset, uint32_t *ret_len) {
-  const char *proplet_id = g_current_task.proplet_id[0] != '\0'
-                            ? g_current_task.proplet_id
-                            : "";
-  return write_string_to_wasm_memory(exec_env, proplet_id, ret_offset, ret_len);
+  return staged_lookup(exec_env, &g_staged_host_data.proplet_id, ret_offset,
+                       ret_len);
 }
 
 static bool get_model_data_wrapper(wasm_exec_env_t exec_env,
                                     uint32_t *ret_offset, uint32_t *ret_len) {
-  const char *model_data = g_current_task.model_data_fetched && g_current_task.model_data[0] != '\0'
-                            ? g_current_task.model_data
-                            : "";
-  return write_string_to_wasm_memory(exec_env, model_data, ret_offset, ret_len);
+  return staged_lookup(exec_env, &g_staged_host_data.model_data, ret_offset,
+                       ret_len);
 }
 
 static bool get_dataset_data_wrapper(wasm_exec_env_t exec_env,
                                       uint32_t *ret_offset, uint32_t *ret_len) {
-  const char *dataset_data = g_current_task.dataset_data_fetched && g_current_task.dataset_data[0] != '\0'
-                              ? g_current_task.dataset_data
-                              : "";
-  return write_string_to_wasm_memory(exec_env, dataset_data, ret_offset, ret_len);
+  return staged_lookup(exec_env, &g_staged_host_data.dataset_data, ret_offset,
+                       ret_len);
 }
 
+/* Watchdog bounding a single WASM invocation. Executions are serialized on
+ * the executor thread, so one timer is enough. Timer expiry runs in ISR
+ * context, where wasm_runtime_terminate() must not be called (it takes the
+ * instance's exception mutex), so expiry only submits a work item and the
+ * system workqueue terminates the instance from thread context. A mutex
+ * guards the instance pointer so the executor can clear it without racing
+ * a late-running work item.
+ */
+static wasm_module_inst_t g_watchdog_inst;
+static volatile bool g_watchdog_fired;
+static K_MUTEX_DEFINE(g_watchdog_mutex);
+
+static void exec_watchdog_work_fn(struct k_work *work)
+{
+  ARG_UNUSED(work);
+  k_mutex_lock(&g_watchdog_mutex, K_FOREVER);
+  if (g_watchdog_inst != NULL)
+  {
+    g_watchdog_fired = true;
+    wasm_runtime_terminate(g_watchdog_inst);
+  }
+  k_mutex_unlock(&g_watchdog_mutex);
+}
+
+K_WORK_DEFINE(g_exec_watchdog_work, exec_watchdog_work_fn);
+
+static void exec_watchdog_expire(struct k_timer *timer)
+{
+  ARG_UNUSED(timer);
+  k_work_submit(&g_exec_watchdog_work);
+}
+
+K_TIMER_DEFINE(g_exec_watchdog, exec_watchdog_expire, NULL);
+
 static NativeSymbol native_symbols[] = {
     {"get_proplet_id", (void*)get_proplet_id_wrapper, "(~i)", NULL},
     {"get_model_data", (void*)get_model_data_wrapper, "(~i)", NULL},
@@ -88,7 +625,7 @@ static NativeSymbol native_symbols[] = {
 
 void execute_wasm_module(const char *task_id, const uint8_t *wasm_data,
                           size_t wasm_size, const uint64_t *inputs,
-                          size_t inputs_count)
+                          size_t inputs_count, uint32_t timeout_ms)
 {
   maybe_init_wamr_runtime();
   if (!g_wamr_initialized)
@@ -97,33 +634,48 @@ void execute_wasm_module(const char *task_id, const uint8_t *wasm_data,
     return;
   }
 
-  k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
+  maybe_init_app_registry();
 
-  if (find_app_by_id(task_id) >= 0)
+  int slot = task_registry_insert(&g_app_registry, task_id);
+  if (slot == -EEXIST)
   {
-    LOG_WRN("WASM app with ID %s is already running. Stopping it first...",
+    /* Executions are serialized on the executor thread, so a duplicate id
+     * means the same task was submitted twice; reject it rather than
+     * tearing down the earlier registration from under ourselves.
+     */
+    LOG_WRN("WASM app with ID %s is already registered, rejecting duplicate",
             task_id);
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    stop_wasm_app(task_id);
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
+    extern const char *channel_id;
+    extern const char *domain_id;
+    publish_results_with_error(domain_id, channel_id, task_id, NULL,
+                               "Task already running");
+    return;
   }
-
-  int slot = find_free_slot();
   if (slot < 0)
   {
     LOG_ERR("No free slot to store new WASM app instance (increase "
-            "MAX_WASM_APPS).");
-    k_mutex_unlock(&g_wasm_apps_mutex);
+            "CONFIG_PROPLET_MAX_TASKS).");
     return;
   }
 
   /* Reserve the slot immediately to prevent race conditions */
+  k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
   g_wasm_apps[slot].in_use = true;
   strncpy(g_wasm_apps[slot].id, task_id, MAX_ID_LEN - 1);
   g_wasm_apps[slot].id[MAX_ID_LEN - 1] = '\0';
-
   k_mutex_unlock(&g_wasm_apps_mutex);
 
+  /* Everything below funnels into the single release path at done:, which
+   * frees exactly what was acquired. Error paths set fail_msg and jump.
+   */
+  wasm_module_t module = NULL;
+  wasm_module_inst_t module_inst = NULL;
+  wasm_exec_env_t exec_env = NULL;
+  bool host_data_staged = false;
+  const char *fail_msg = NULL;
+  char error_buf[128];
+  char error_msg[256];
+
   bool monitoring_started = false;
   if (task_monitor_start(task_id) == 0)
   {
@@ -134,25 +686,32 @@ void execute_wasm_module(const char *task_id, const uint8_t *wasm_data,
     LOG_WRN("Failed to start task monitoring for %s", task_id);
   }
 
-  char error_buf[128];
-  wasm_module_t module =
-      wasm_runtime_load(wasm_data, wasm_size, error_buf, sizeof(error_buf));
+  const char *format = wasm_image_format(wasm_data, wasm_size);
+  if (format == NULL)
+  {
+    LOG_ERR("Module image has neither wasm nor aot magic bytes.");
+    fail_msg = "Unrecognized module format";
+    goto done;
+  }
+#if !PROPLET_WAMR_AOT
+  if (strcmp(format, "aot") == 0)
+  {
+    LOG_ERR("AOT image received but WAMR was built without AOT support.");
+    fail_msg = "AOT modules not supported by this build";
+    goto done;
+  }
+#endif
+  LOG_INF("Loading %s module (%zu bytes)", format, wasm_size);
+
+  TASK_TRACE_MARK(load_start);
+  module =
+      module_cache_acquire(wasm_data, wasm_size, error_buf, sizeof(error_buf));
+  TASK_TRACE_STAGE(task_id, TASK_TRACE_STAGE_LOAD, load_start);
   if (!module)
   {
     LOG_ERR("Failed to load WASM module: %s", error_buf);
-    if (monitoring_started)
-    {
-      task_monitor_stop(task_id);
-    }
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_buf);
-    /* Release reserved slot */
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-    g_wasm_apps[slot].in_use = false;
-    memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    return;
+    fail_msg = error_buf;
+    goto done;
   }
 
   uint32_t n_native_symbols = sizeof(native_symbols) / sizeof(NativeSymbol);
@@ -160,205 +719,239 @@ void execute_wasm_module(const char *task_id, const uint8_t *wasm_data,
     LOG_WRN("Failed to register native symbols, host functions may not be available");
   }
 
-  wasm_module_inst_t module_inst =
-      wasm_runtime_instantiate(module, 16 * 1024, /* stack size */
-                               16 * 1024,         /* heap size */
-                               error_buf, sizeof(error_buf));
-  if (!module_inst)
+  TASK_TRACE_MARK(inst_start);
+  if (!instance_pool_acquire(module, &module_inst, &exec_env))
   {
-    LOG_ERR("Failed to instantiate WASM module: %s", error_buf);
-    if (monitoring_started)
+    module_inst =
+        wasm_runtime_instantiate(module, WASM_INST_STACK_SIZE,
+                                 WASM_INST_HEAP_SIZE,
+                                 error_buf, sizeof(error_buf));
+    if (!module_inst)
     {
-      task_monitor_stop(task_id);
+      LOG_ERR("Failed to instantiate WASM module: %s", error_buf);
+      fail_msg = error_buf;
+      goto done;
+    }
+
+    exec_env = wasm_runtime_create_exec_env(module_inst, WASM_INST_STACK_SIZE);
+    if (!exec_env)
+    {
+      LOG_ERR("Failed to create execution environment for WASM module.");
+      fail_msg = "Failed to create execution environment";
+      goto done;
     }
-    wasm_runtime_unload(module);
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_buf);
-    /* Release reserved slot */
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-    g_wasm_apps[slot].in_use = false;
-    memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    return;
   }
+  TASK_TRACE_STAGE(task_id, TASK_TRACE_STAGE_INSTANTIATE, inst_start);
 
-  /* Store module handles in the reserved slot */
+  /* Store module handles in the reserved slot. A stop request that raced
+   * the setup phase only finds the instance from this point on, so honor a
+   * flag raised before the handles were visible here.
+   */
   k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
   g_wasm_apps[slot].module = module;
   g_wasm_apps[slot].module_inst = module_inst;
+  g_wasm_apps[slot].exec_env = exec_env;
+  bool stop_requested = g_wasm_apps[slot].stop_requested;
   k_mutex_unlock(&g_wasm_apps_mutex);
 
+  if (stop_requested)
+  {
+    LOG_INF("Task %s stopped before execution started", task_id);
+    fail_msg = "Task stopped before execution";
+    goto done;
+  }
+
   wasm_function_inst_t func = wasm_runtime_lookup_function(module_inst, "main");
   if (!func)
   {
     LOG_WRN(
         "Function 'main' not found in WASM module. No entry point to call.");
-    if (monitoring_started)
-    {
-      task_monitor_stop(task_id);
-    }
-    wasm_runtime_deinstantiate(module_inst);
-    wasm_runtime_unload(module);
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_buf);
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-    g_wasm_apps[slot].in_use = false;
-    memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    return;
+    fail_msg = "Function 'main' not found in WASM module";
+    goto done;
   }
 
   uint32_t result_count = wasm_func_get_result_count(func, module_inst);
   if (result_count == 0)
   {
     LOG_ERR("Function has no return value.");
-    if (monitoring_started)
+    fail_msg = "Function has no return value";
+    goto done;
+  }
+
+  /* Inner scope keeps the VLAs out of the done: label's scope */
+  {
+    wasm_valkind_t result_types[result_count];
+    wasm_func_get_result_types(func, module_inst, result_types);
+
+    wasm_val_t results[result_count];
+    for (uint32_t i = 0; i < result_count; i++)
     {
-      task_monitor_stop(task_id);
+      results[i].kind = result_types[i];
     }
-    wasm_runtime_deinstantiate(module_inst);
-    wasm_runtime_unload(module);
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_buf);
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-    g_wasm_apps[slot].in_use = false;
-    memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    return;
-  }
 
-  wasm_valkind_t result_types[result_count];
-  wasm_func_get_result_types(func, module_inst, result_types);
+    wasm_val_t args[MAX_INPUTS];
+    size_t n_args = (inputs_count > MAX_INPUTS) ? MAX_INPUTS : inputs_count;
+    for (size_t i = 0; i < n_args; i++)
+    {
+      args[i].kind = WASM_I32;
+      args[i].of.i32 = (uint32_t)(inputs[i] & 0xFFFFFFFFu);
+    }
 
-  g_wasm_apps[slot].in_use = true;
-  strncpy(g_wasm_apps[slot].id, task_id, MAX_ID_LEN);
-  g_wasm_apps[slot].module = module;
-  g_wasm_apps[slot].module_inst = module_inst;
+    stage_host_data(module_inst);
+    host_data_staged = true;
 
-  wasm_val_t results[result_count];
-  for (uint32_t i = 0; i < result_count; i++)
-  {
-    results[i].kind = result_types[i];
-  }
+    if (timeout_ms > 0)
+    {
+      k_mutex_lock(&g_watchdog_mutex, K_FOREVER);
+      g_watchdog_fired = false;
+      g_watchdog_inst = module_inst;
+      k_mutex_unlock(&g_watchdog_mutex);
+      k_timer_start(&g_exec_watchdog, K_MSEC(timeout_ms), K_NO_WAIT);
+    }
 
-  wasm_val_t args[MAX_INPUTS];
-  size_t n_args = (inputs_count > MAX_INPUTS) ? MAX_INPUTS : inputs_count;
-  for (size_t i = 0; i < n_args; i++)
-  {
-    args[i].kind = WASM_I32;
-    args[i].of.i32 = (uint32_t)(inputs[i] & 0xFFFFFFFFu);
-  }
+    TASK_TRACE_MARK(call_start);
+    bool call_ok = wasm_runtime_call_wasm_a(exec_env, func, result_count,
+                                            results, n_args, args);
+    TASK_TRACE_STAGE(task_id, TASK_TRACE_STAGE_CALL, call_start);
 
-  wasm_exec_env_t exec_env =
-      wasm_runtime_create_exec_env(module_inst, 16 * 1024);
-  if (!exec_env)
-  {
+    if (timeout_ms > 0)
+    {
+      k_timer_stop(&g_exec_watchdog);
+      k_mutex_lock(&g_watchdog_mutex, K_FOREVER);
+      g_watchdog_inst = NULL;
+      k_mutex_unlock(&g_watchdog_mutex);
+    }
 
-    
-    LOG_ERR("Failed to create execution environment for WASM module.");
-    if (monitoring_started)
+    if (!call_ok)
     {
-      task_monitor_stop(task_id);
+      if (g_watchdog_fired)
+      {
+        snprintf(error_msg, sizeof(error_msg),
+                 "WASM execution timed out after %u ms", timeout_ms);
+      }
+      else
+      {
+        const char *exception = wasm_runtime_get_exception(module_inst);
+        snprintf(error_msg, sizeof(error_msg), "WASM execution failed: %s",
+                 exception ? exception : "Unknown error");
+      }
+      LOG_ERR("Error invoking WASM function: %s", error_msg);
+      fail_msg = error_msg;
+      goto done;
     }
-    wasm_runtime_deinstantiate(module_inst);
-    wasm_runtime_unload(module);
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_buf);
-    k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-    g_wasm_apps[slot].in_use = false;
-    memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
-    k_mutex_unlock(&g_wasm_apps_mutex);
-    return;
-  }
 
-  if (!wasm_runtime_call_wasm_a(exec_env, func, result_count, results, n_args,
-                                args))
-  {
-    const char *exception = wasm_runtime_get_exception(module_inst);
-    char error_msg[256];
-    snprintf(error_msg, sizeof(error_msg), "WASM execution failed: %s",
-             exception ? exception : "Unknown error");
-    LOG_ERR("Error invoking WASM function: %s", error_msg);
-    
-    extern const char *channel_id;
-    extern const char *domain_id;
-    publish_results_with_error(domain_id, channel_id, task_id, NULL, error_msg);
-  }
-  else
-  {
     char results_string[MAX_RESULTS * 16] = {0};
+    size_t pos = 0;
 
-    for (uint32_t i = 0; i < result_count; i++)
+    /* Append at a cursor instead of strncat re-scanning the string */
+    for (uint32_t i = 0; i < result_count && pos < sizeof(results_string); i++)
     {
       if (results[i].kind == WASM_I32)
       {
-        char temp[16];
-        snprintf(temp, sizeof(temp), "%d", results[i].of.i32);
-        strncat(results_string, temp,
-                sizeof(results_string) - strlen(results_string) - 1);
-        if (i < result_count - 1)
+        int written = snprintf(results_string + pos,
+                               sizeof(results_string) - pos, "%s%d",
+                               (pos > 0) ? "," : "", results[i].of.i32);
+        if (written < 0 || (size_t)written >= sizeof(results_string) - pos)
         {
-          strncat(results_string, ",",
-                  sizeof(results_string) - strlen(results_string) - 1);
+          LOG_WRN("Results string truncated at %u of %u values", i,
+                  result_count);
+          break;
         }
+        pos += (size_t)written;
       }
     }
 
     extern const char *channel_id;
     extern const char *domain_id;
+    TASK_TRACE_MARK(publish_start);
     publish_results(domain_id, channel_id, task_id, results_string);
+    TASK_TRACE_STAGE(task_id, TASK_TRACE_STAGE_PUBLISH, publish_start);
     LOG_INF("WASM execution results published to MQTT topic");
   }
 
+done:
+  if (fail_msg != NULL)
+  {
+    extern const char *channel_id;
+    extern const char *domain_id;
+    TASK_TRACE_MARK(publish_start);
+    publish_results_with_error(domain_id, channel_id, task_id, NULL, fail_msg);
+    TASK_TRACE_STAGE(task_id, TASK_TRACE_STAGE_PUBLISH, publish_start);
+  }
+
+  if (host_data_staged)
+  {
+    unstage_host_data();
+  }
+
   if (monitoring_started)
   {
     task_monitor_stop(task_id);
   }
 
-  wasm_runtime_destroy_exec_env(exec_env);
-  wasm_runtime_deinstantiate(module_inst);
-  wasm_runtime_unload(module);
+  if (module_inst != NULL && exec_env != NULL)
+  {
+    instance_pool_release(module, module_inst, exec_env);
+  }
+  else if (module_inst != NULL)
+  {
+    wasm_runtime_deinstantiate(module_inst);
+  }
+  if (module != NULL)
+  {
+    module_cache_release(module);
+  }
 
-  /* Release the slot */
+  /* Release the slot and its id mapping */
   k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
-  g_wasm_apps[slot].in_use = false;
-  memset(g_wasm_apps[slot].id, 0, sizeof(g_wasm_apps[slot].id));
+  memset(&g_wasm_apps[slot], 0, sizeof(g_wasm_apps[slot]));
   k_mutex_unlock(&g_wasm_apps_mutex);
+  (void)task_registry_remove(&g_app_registry, task_id);
 }
 
+/* Signal-only: the executor thread owns every handle it acquired and frees
+ * them through its single release path, so stopping from the MQTT thread
+ * must not release anything here. Raising the flag and terminating the
+ * running instance makes the in-flight call return with an exception, after
+ * which the executor cleans up as it would for any failed execution.
+ */
 void stop_wasm_app(const char *task_id)
 {
-  k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
+  maybe_init_app_registry();
 
-  int idx = find_app_by_id(task_id);
+  int idx = task_registry_find(&g_app_registry, task_id);
   if (idx < 0)
   {
     LOG_WRN("No running WASM app found with ID=%s", task_id);
-    k_mutex_unlock(&g_wasm_apps_mutex);
     return;
   }
 
-  wasm_app_t *app = &g_wasm_apps[idx];
-  LOG_INF("Stopping WASM app with ID=%s", app->id);
-
-  /* Stop task monitoring if active (task_monitor has its own mutex) */
-  task_monitor_stop(task_id);
+  k_mutex_lock(&g_wasm_apps_mutex, K_FOREVER);
 
-  wasm_runtime_deinstantiate(app->module_inst);
-  wasm_runtime_unload(app->module);
+  wasm_app_t *app = &g_wasm_apps[idx];
+  if (!app->in_use || strncmp(app->id, task_id, MAX_ID_LEN) != 0)
+  {
+    k_mutex_unlock(&g_wasm_apps_mutex);
+    LOG_WRN("WASM app slot for ID=%s already released", task_id);
+    return;
+  }
 
-  app->in_use = false;
-  memset(app->id, 0, sizeof(app->id));
+  app->stop_requested = true;
+  if (app->module_inst != NULL)
+  {
+    wasm_runtime_terminate(app->module_inst);
+  }
 
   k_mutex_unlock(&g_wasm_apps_mutex);
 
-  LOG_INF("WASM app [%s] has been stopped and unloaded.", task_id);
+  LOG_INF("Stop requested for WASM app [%s]", task_id);
 }
 
+/* Dedicated arena for the WAMR runtime so WASM allocations never contend
+ * with (or fragment) the shared system heap. Sized via Kconfig.
+ */
+static uint8_t g_wamr_pool[CONFIG_PROPLET_WAMR_POOL_SIZE];
+
 static void maybe_init_wamr_runtime(void)
 {
   if (g_wamr_initialized)
@@ -368,7 +961,9 @@ static void maybe_init_wamr_runtime(void)
 
   RuntimeInitArgs init_args;
   memset(&init_args, 0, sizeof(init_args));
-  init_args.mem_alloc_type = Alloc_With_System_Allocator;
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = g_wamr_pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(g_wamr_pool);
 
   if (!wasm_runtime_full_init(&init_args))
   {
@@ -377,29 +972,35 @@ static void maybe_init_wamr_runtime(void)
   }
 
   g_wamr_initialized = true;
-  LOG_INF("WAMR runtime initialized successfully.");
+  LOG_INF("WAMR runtime initialized with %u-byte static pool.",
+          (unsigned int)sizeof(g_wamr_pool));
 }
 
-static int find_free_slot(void)
+int wasm_handler_get_pool_stats(uint32_t *total_size, uint32_t *free_size,
+                                uint32_t *highmark_size)
 {
-  for (int i = 0; i < MAX_WASM_APPS; i++)
+  if (!g_wamr_initialized)
   {
-    if (!g_wasm_apps[i].in_use)
-    {
-      return i;
-    }
+    return -1;
   }
-  return -1;
-}
 
-static int find_app_by_id(const char *task_id)
-{
-  for (int i = 0; i < MAX_WASM_APPS; i++)
+  mem_alloc_info_t info;
+  if (!wasm_runtime_get_mem_alloc_info(&info))
   {
-    if (g_wasm_apps[i].in_use && (strcmp(g_wasm_apps[i].id, task_id) == 0))
-    {
-      return i;
-    }
+    return -1;
+  }
+
+  if (total_size != NULL)
+  {
+    *total_size = info.total_size;
+  }
+  if (free_size != NULL)
+  {
+    *free_size = info.total_free_size;
+  }
+  if (highmark_size != NULL)
+  {
+    *highmark_size = info.highmark_size;
   }
-  return -1;
+  return 0;
 }
@@ -20,20 +20,54 @@ extern "C"
      * @param inputs      Array of 64-bit inputs that the Wasm main function might
      * consume.
      * @param inputs_count Number of elements in the 'inputs' array.
+     * @param timeout_ms  Execution deadline in milliseconds; the module is
+     * terminated and a timeout error published when it passes. 0 disables the
+     * deadline.
      */
     void execute_wasm_module(const char *task_id, const uint8_t *wasm_data,
                              size_t wasm_size, const uint64_t *inputs,
-                             size_t inputs_count);
+                             size_t inputs_count, uint32_t timeout_ms);
 
     /**
-     * Stops the Wasm module with the given task_id by deinstantiating and unloading
-     * it from memory.
+     * Requests that the Wasm module with the given task_id stop: the running
+     * instance is terminated via WAMR and the executor's release path frees the
+     * module resources. Safe to call from any thread; nothing is torn down here.
      *
      * @param task_id  The unique string ID assigned to the Wasm module at start
      * time.
      */
     void stop_wasm_app(const char *task_id);
 
+    /**
+     * Records the host data (proplet id and any fetched model/dataset buffers)
+     * that the next execute_wasm_module() call stages into the instance's linear
+     * memory. Called by the executor thread per job, so the handler never reads
+     * the MQTT thread's task state.
+     *
+     * @param proplet_id   Proplet identity string (may be empty).
+     * @param model_data   Fetched model bytes, or NULL if none.
+     * @param model_len    Length of model_data in bytes.
+     * @param dataset_data Fetched dataset bytes, or NULL if none.
+     * @param dataset_len  Length of dataset_data in bytes.
+     */
+    void wasm_handler_set_host_data(const char *proplet_id,
+                                    const uint8_t *model_data, size_t model_len,
+                                    const uint8_t *dataset_data,
+                                    size_t dataset_len);
+
+    /**
+     * Reports usage of the static memory pool backing the WAMR runtime.
+     *
+     * @param total_size    Pool capacity in bytes (may be NULL).
+     * @param free_size     Bytes currently free in the pool (may be NULL).
+     * @param highmark_size High-water mark of pool usage in bytes (may be NULL).
+     *
+     * @return 0 on success, -1 if the runtime is not initialized or stats are
+     * unavailable.
+     */
+    int wasm_handler_get_pool_stats(uint32_t *total_size, uint32_t *free_size,
+                                    uint32_t *highmark_size);
+
 #ifdef __cplusplus
 }
 #endif
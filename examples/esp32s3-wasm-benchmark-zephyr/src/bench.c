@@ -1,4 +1,5 @@
 #include "bench.h"
+#include "chan.h"
 #include "metrics.h"
 #include "wasm_bins.h"
 #include "wasm_tasks.h"
@@ -61,6 +62,7 @@ static void wasm_worker_entry(void *p1, void *p2, void *p3)
     if (!inst->module_inst) {
         LOG_WRN("[%d] instantiate failed: %s", inst->id, err);
         inst->errors++;
+        inst->instantiate_failures++;
         inst->alive = false;
         return;
     }
@@ -72,6 +74,7 @@ static void wasm_worker_entry(void *p1, void *p2, void *p3)
     if (!inst->exec_env) {
         LOG_WRN("[%d] create_exec_env failed", inst->id);
         inst->errors++;
+        inst->instantiate_failures++;
         wasm_runtime_deinstantiate((wasm_module_inst_t)inst->module_inst);
         inst->module_inst = NULL;
         inst->alive = false;
@@ -94,12 +97,13 @@ static void wasm_worker_entry(void *p1, void *p2, void *p3)
     while (inst->running) {
         uint64_t t0 = k_cyc_to_us_floor64(k_cycle_get_64());
 
-        uint32_t argv[2] = {0, 0};
+        uint32_t argv[2] = {inst->arg0, 0};
         bool ok = wasm_runtime_call_wasm(
             (wasm_exec_env_t)inst->exec_env, main_fn, 2, argv);
 
         inst->last_latency_us = (uint32_t)(
             k_cyc_to_us_floor64(k_cycle_get_64()) - t0);
+        lat_hist_record(&inst->hist, inst->last_latency_us);
 
         if (!ok) {
             const char *ex = wasm_runtime_get_exception(
@@ -124,7 +128,7 @@ done:
 }
 
 static bool spawn_instance(int idx, const bench_config_t *cfg,
-                           void *module, const char *name)
+                           void *module, const char *name, uint32_t arg0)
 {
     if (idx >= MAX_INSTANCES) {
         LOG_WRN("instance index %d >= MAX_INSTANCES %d", idx, MAX_INSTANCES);
@@ -141,6 +145,8 @@ static bool spawn_instance(int idx, const bench_config_t *cfg,
     inst->wasm_stack_bytes = cfg->wasm_stack_kb * 1024;
     inst->parent_module    = module ? module : (void *)s_shared_module;
     inst->task_name        = name;
+    inst->arg0             = arg0;
+    inst->pinned_core      = -1;
 
     inst->tid = k_thread_create(
         &inst->thread_data,
@@ -159,8 +165,25 @@ static bool spawn_instance(int idx, const bench_config_t *cfg,
     }
 
 #ifdef CONFIG_SCHED_CPU_MASK
-    if (cfg->core_affinity >= 0) {
-        k_thread_cpu_pin(inst->tid, cfg->core_affinity);
+    int core = -1;
+
+    switch (cfg->pin_mode) {
+    case PIN_EXPLICIT:
+        core = cfg->core_affinity;
+        break;
+    case PIN_ROUND_ROBIN:
+        core = idx % CONFIG_MP_MAX_NUM_CPUS;
+        break;
+    case PIN_NONE:
+    default:
+        /* Legacy knob: core_affinity >= 0 still pins without a mode */
+        core = cfg->core_affinity;
+        break;
+    }
+
+    if (core >= 0) {
+        k_thread_cpu_pin(inst->tid, core);
+        inst->pinned_core = core;
     }
 #endif
 
@@ -181,20 +204,63 @@ static void stop_all_instances(void)
     s_instance_count = 0;
 }
 
+/* Workers keep appending while we read; the tear is harmless for a dump */
+static void merge_latency_hists(latency_hist_t *out)
+{
+    lat_hist_reset(out);
+    for (int i = 0; i < s_instance_count; i++) {
+        lat_hist_merge(out, &s_instances[i].hist);
+    }
+}
+
+static void print_latency_line(const char *indent, const latency_hist_t *h)
+{
+    printf("%slatency p50=%uus  p95=%uus  p99=%uus  max=%uus  (n=%u)\n",
+           indent,
+           (unsigned)lat_hist_percentile(h, 50),
+           (unsigned)lat_hist_percentile(h, 95),
+           (unsigned)lat_hist_percentile(h, 99),
+           (unsigned)h->max_us,
+           (unsigned)h->total);
+}
+
 static void print_instance_stats(void)
 {
+    latency_hist_t all;
+
     printf("\n--- Instance detail ---\n");
-    printf("  id  task        iters     errors  latency_us\n");
+    printf("  id  task        core  iters     errors  p50_us    p95_us    p99_us    max_us\n");
     for (int i = 0; i < s_instance_count; i++) {
         bench_instance_t *inst = &s_instances[i];
         const char *label = inst->task_name ? inst->task_name
                                              : workload_name(inst->workload);
-        printf("  %-3d %-10s  %-8u  %-6u  %u\n",
+        char core_str[4] = "-";
+
+        if (inst->pinned_core >= 0) {
+            snprintf(core_str, sizeof(core_str), "%d", inst->pinned_core);
+        }
+        printf("  %-3d %-10s  %-4s  %-8u  %-6u  %-8u  %-8u  %-8u  %u\n",
                inst->id,
                label,
+               core_str,
                (unsigned)inst->iterations,
                (unsigned)inst->errors,
-               (unsigned)inst->last_latency_us);
+               (unsigned)lat_hist_percentile(&inst->hist, 50),
+               (unsigned)lat_hist_percentile(&inst->hist, 95),
+               (unsigned)lat_hist_percentile(&inst->hist, 99),
+               (unsigned)inst->hist.max_us);
+    }
+
+    merge_latency_hists(&all);
+    print_latency_line("  all: ", &all);
+
+    uint32_t inst_fails = 0;
+
+    for (int i = 0; i < s_instance_count; i++) {
+        inst_fails += s_instances[i].instantiate_failures;
+    }
+    if (inst_fails > 0) {
+        printf("  instantiate failures: %u\n", (unsigned)inst_fails);
     }
     printf("---\n\n");
 }
@@ -206,6 +272,7 @@ void bench_config_default(bench_config_t *cfg)
     cfg->wasm_stack_kb    = 4;
     cfg->wasm_heap_kb     = 8;
     cfg->task_stack_kb    = 6;
+    cfg->pin_mode         = PIN_NONE;
     cfg->core_affinity    = -1;
     cfg->scale_delay_ms   = 500;
     cfg->measure_delay_ms = 2000;
@@ -251,6 +318,7 @@ int bench_run(const bench_config_t *cfg)
 
     s_instance_count = 0;
     metrics_init();
+    metrics_phase_begin(workload_name(cfg->workload));
 
     for (int n = 1; n <= cfg->max_instances; n++) {
         metrics_t m_before;
@@ -259,7 +327,7 @@ int bench_run(const bench_config_t *cfg)
 
         if (!spawn_instance(s_instance_count, cfg,
                             (void *)s_shared_module,
-                            workload_name(cfg->workload))) {
+                            workload_name(cfg->workload), 0)) {
             printf("instances=%-3d  SPAWN_FAIL\n", n);
             break;
         }
@@ -283,6 +351,11 @@ int bench_run(const bench_config_t *cfg)
         metrics_sample(&m);
         metrics_print(s_instance_count, &m);
 
+        latency_hist_t all;
+
+        merge_latency_hists(&all);
+        print_latency_line("  ", &all);
+
         uint32_t delta = (m_before.heap_free > m.heap_free) ?
                          (m_before.heap_free - m.heap_free) : 0;
         printf("  +instance cost ~%uKB  latency %uus\n",
@@ -297,12 +370,14 @@ int bench_run(const bench_config_t *cfg)
     stop_all_instances();
     wasm_runtime_unload(s_shared_module);
     s_shared_module = NULL;
+    metrics_phase_end();
 
     metrics_t m_final;
 
     metrics_sample(&m_final);
-    printf("Post-teardown heap: %uKB free\n\n",
-           (unsigned)(m_final.heap_free / 1024));
+    printf("Post-teardown heap: %uKB free  largest block: %uKB\n\n",
+           (unsigned)(m_final.heap_free / 1024),
+           (unsigned)(m_final.heap_largest_block / 1024));
 
     return peak_instances;
 }
@@ -348,6 +423,200 @@ void bench_compare_modes(const bench_config_t *base_cfg)
     printf("Shared module: %d instances\n", shared);
 }
 
+/*
+ * Scaling sweep: ramp instance count 1 -> max per workload, hold each
+ * step for the measure window, and keep one result row per step so the
+ * full scaling curve comes out of a single flash. Rows are buffered and
+ * dumped as CSV over UART at the end, where the console is quiet.
+ */
+typedef struct {
+    workload_type_t workload;
+    int             instances;
+    uint32_t        window_ms;
+    uint32_t        iters;
+    uint32_t        p50_us;
+    uint32_t        p95_us;
+    uint32_t        p99_us;
+    uint32_t        max_us;
+    uint32_t        heap_free;
+    uint32_t        heap_min;
+    uint32_t        cpu_percent;
+} sweep_row_t;
+
+static sweep_row_t s_sweep_rows[WORKLOAD_COUNT * MAX_INSTANCES];
+static int         s_sweep_row_count;
+
+/* Windowed histogram: bucket counts only ever grow, so now - before is
+ * the activity inside the window (max_us stays cumulative).
+ */
+static void lat_hist_delta(latency_hist_t *out, const latency_hist_t *now,
+                           const latency_hist_t *before)
+{
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        out->counts[i] = now->counts[i] - before->counts[i];
+    }
+    out->total  = now->total - before->total;
+    out->max_us = now->max_us;
+}
+
+static uint32_t total_iterations(void)
+{
+    uint32_t sum = 0;
+
+    for (int i = 0; i < s_instance_count; i++) {
+        sum += s_instances[i].iterations;
+    }
+    return sum;
+}
+
+static void sweep_one_workload(const bench_config_t *cfg)
+{
+    uint32_t wasm_len = 0;
+    const uint8_t *wasm_ro = workload_bytes(cfg->workload, &wasm_len);
+
+    if (!wasm_ro || wasm_len == 0) {
+        LOG_ERR("No WASM bytes for workload %d", cfg->workload);
+        return;
+    }
+
+    uint8_t *wasm_bytes = malloc(wasm_len);
+
+    if (!wasm_bytes) {
+        LOG_ERR("malloc(%u) for WASM buffer failed", (unsigned)wasm_len);
+        return;
+    }
+    memcpy(wasm_bytes, wasm_ro, wasm_len);
+
+    char err[ERROR_BUF_SIZE];
+
+    s_shared_module = wasm_runtime_load(wasm_bytes, wasm_len, err, sizeof(err));
+
+    if (!s_shared_module) {
+        LOG_ERR("wasm_runtime_load failed: %s", err);
+        free(wasm_bytes);
+        return;
+    }
+
+    s_instance_count = 0;
+    metrics_init();
+    metrics_phase_begin(workload_name(cfg->workload));
+
+    printf("--- sweep: workload=%s ---\n", workload_name(cfg->workload));
+
+    for (int n = 1; n <= cfg->max_instances; n++) {
+        if (!spawn_instance(s_instance_count, cfg,
+                            (void *)s_shared_module,
+                            workload_name(cfg->workload), 0)) {
+            printf("  n=%-3d SPAWN_FAIL\n", n);
+            break;
+        }
+        s_instance_count++;
+
+        k_sleep(K_MSEC(cfg->scale_delay_ms));
+
+        if (!s_instances[s_instance_count - 1].alive) {
+            printf("  n=%-3d TASK_DIED (errors=%u)\n",
+                   n, (unsigned)s_instances[s_instance_count - 1].errors);
+            s_instance_count--;
+            break;
+        }
+
+        uint32_t       iters0 = total_iterations();
+        latency_hist_t h0;
+
+        merge_latency_hists(&h0);
+
+        int64_t t0 = k_uptime_get();
+
+        k_sleep(K_MSEC(cfg->measure_delay_ms));
+
+        uint32_t       window_ms = (uint32_t)(k_uptime_get() - t0);
+        latency_hist_t h1;
+        latency_hist_t hw;
+
+        merge_latency_hists(&h1);
+        lat_hist_delta(&hw, &h1, &h0);
+
+        metrics_t m;
+
+        metrics_sample(&m);
+
+        sweep_row_t *row = &s_sweep_rows[s_sweep_row_count++];
+
+        row->workload    = cfg->workload;
+        row->instances   = n;
+        row->window_ms   = window_ms;
+        row->iters       = total_iterations() - iters0;
+        row->p50_us      = lat_hist_percentile(&hw, 50);
+        row->p95_us      = lat_hist_percentile(&hw, 95);
+        row->p99_us      = lat_hist_percentile(&hw, 99);
+        row->max_us      = hw.max_us;
+        row->heap_free   = m.heap_free;
+        row->heap_min    = m.heap_min;
+        row->cpu_percent = m.cpu_percent;
+
+        printf("  n=%-3d iters=%-6u p50=%6uus p99=%6uus heap=%4uKB cpu=%3u%%\n",
+               n, (unsigned)row->iters,
+               (unsigned)row->p50_us, (unsigned)row->p99_us,
+               (unsigned)(m.heap_free / 1024), (unsigned)m.cpu_percent);
+    }
+
+    stop_all_instances();
+    wasm_runtime_unload(s_shared_module);
+    s_shared_module = NULL;
+    free(wasm_bytes);
+    metrics_phase_end();
+}
+
+static void sweep_emit_csv(void)
+{
+    printf("\n=== CSV BEGIN ===\n");
+    printf("workload,instances,window_ms,iters,throughput_ips,"
+           "p50_us,p95_us,p99_us,max_us,heap_free,heap_min,cpu_pct\n");
+    for (int i = 0; i < s_sweep_row_count; i++) {
+        sweep_row_t *r = &s_sweep_rows[i];
+        uint32_t ips = (r->window_ms > 0) ?
+                       (uint32_t)(((uint64_t)r->iters * 1000U) / r->window_ms)
+                       : 0;
+
+        printf("%s,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+               workload_name(r->workload),
+               r->instances,
+               (unsigned)r->window_ms,
+               (unsigned)r->iters,
+               (unsigned)ips,
+               (unsigned)r->p50_us,
+               (unsigned)r->p95_us,
+               (unsigned)r->p99_us,
+               (unsigned)r->max_us,
+               (unsigned)r->heap_free,
+               (unsigned)r->heap_min,
+               (unsigned)r->cpu_percent);
+    }
+    printf("=== CSV END ===\n\n");
+}
+
+void bench_run_sweep(const bench_config_t *base_cfg)
+{
+    bench_config_t cfg;
+
+    s_sweep_row_count = 0;
+
+    printf("\n╔══════════════════════════════════════════╗\n");
+    printf("║  SCALING SWEEP (1 -> %-2d per workload)    ║\n",
+           base_cfg->max_instances);
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    for (int w = 0; w < WORKLOAD_COUNT; w++) {
+        memcpy(&cfg, base_cfg, sizeof(cfg));
+        cfg.workload = (workload_type_t)w;
+        sweep_one_workload(&cfg);
+        k_sleep(K_MSEC(2000));
+    }
+
+    sweep_emit_csv();
+}
+
 #define DIVERSE_TASK_COUNT 5
 
 static const struct {
@@ -406,6 +675,7 @@ void bench_run_diverse(const bench_config_t *cfg)
 
     s_instance_count = 0;
     metrics_init();
+    metrics_phase_begin("diverse");
 
     int peak_sets = 0;
     int max_sets  = cfg->max_instances / DIVERSE_TASK_COUNT;
@@ -415,7 +685,7 @@ void bench_run_diverse(const bench_config_t *cfg)
 
         for (int t = 0; t < DIVERSE_TASK_COUNT && ok; t++) {
             if (!spawn_instance(s_instance_count, cfg,
-                                (void *)modules[t], s_task_defs[t].name)) {
+                                (void *)modules[t], s_task_defs[t].name, 0)) {
                 printf("  SPAWN_FAIL  task=%s\n", s_task_defs[t].name);
                 ok = false;
             } else {
@@ -457,20 +727,20 @@ void bench_run_diverse(const bench_config_t *cfg)
                (unsigned)(m.uptime_ms / 1000));
 
         for (int t = 0; t < DIVERSE_TASK_COUNT; t++) {
-            uint64_t lat_sum  = 0;
+            latency_hist_t task_hist;
             uint32_t iter_sum = 0;
             uint32_t err_sum  = 0;
-            int      count    = 0;
 
+            lat_hist_reset(&task_hist);
             for (int i = t; i < s_instance_count; i += DIVERSE_TASK_COUNT) {
-                lat_sum  += s_instances[i].last_latency_us;
+                lat_hist_merge(&task_hist, &s_instances[i].hist);
                 iter_sum += s_instances[i].iterations;
                 err_sum  += s_instances[i].errors;
-                count++;
             }
-            printf("  %-10s  latency=%6uus  iters=%-6u  errors=%u\n",
+            printf("  %-10s  p50=%6uus  p99=%6uus  iters=%-6u  errors=%u\n",
                    s_task_defs[t].name,
-                   count ? (unsigned)(lat_sum / count) : 0,
+                   (unsigned)lat_hist_percentile(&task_hist, 50),
+                   (unsigned)lat_hist_percentile(&task_hist, 99),
                    (unsigned)iter_sum,
                    (unsigned)err_sum);
         }
@@ -483,12 +753,14 @@ void bench_run_diverse(const bench_config_t *cfg)
     print_instance_stats();
 
     stop_all_instances();
+    metrics_phase_end();
 
     metrics_t m_final;
 
     metrics_sample(&m_final);
-    printf("Post-teardown heap: %uKB free\n\n",
-           (unsigned)(m_final.heap_free / 1024));
+    printf("Post-teardown heap: %uKB free  largest block: %uKB\n\n",
+           (unsigned)(m_final.heap_free / 1024),
+           (unsigned)(m_final.heap_largest_block / 1024));
 
 cleanup:
     for (int t = 0; t < loaded; t++) {
@@ -502,3 +774,122 @@ cleanup:
         }
     }
 }
+
+/*
+ * Channel throughput: producer/consumer instance pairs exchanging i32
+ * messages through the host rings in chan.c instead of a broker
+ * round-trip. Pair p polls ring p % CHAN_COUNT; throughput is the
+ * windowed delta of values actually received.
+ */
+void bench_run_channel(const bench_config_t *cfg)
+{
+    static const struct {
+        const char    *name;
+        const uint8_t *bytes_ro;
+        uint32_t       len;
+    } defs[2] = {
+        { "chan_prod", wasm_chan_producer, wasm_chan_producer_len },
+        { "chan_cons", wasm_chan_consumer, wasm_chan_consumer_len },
+    };
+    wasm_module_t modules[2] = { NULL, NULL };
+    uint8_t      *bufs[2]    = { NULL, NULL };
+    char          err[ERROR_BUF_SIZE];
+
+    printf("\n╔══════════════════════════════════════════╗\n");
+    printf("║  CHANNEL THROUGHPUT (producer/consumer)  ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+    printf("rings=%d  depth=%d  pairs up to %d\n\n",
+           CHAN_COUNT, CHAN_DEPTH, cfg->max_instances / 2);
+
+    if (!chan_register_natives()) {
+        LOG_ERR("chan native symbol registration failed");
+        return;
+    }
+
+    for (int t = 0; t < 2; t++) {
+        bufs[t] = malloc(defs[t].len);
+        if (!bufs[t]) {
+            LOG_ERR("malloc failed for %s", defs[t].name);
+            goto cleanup;
+        }
+        memcpy(bufs[t], defs[t].bytes_ro, defs[t].len);
+
+        modules[t] = wasm_runtime_load(bufs[t], defs[t].len,
+                                       err, sizeof(err));
+        if (!modules[t]) {
+            LOG_ERR("wasm_runtime_load failed for %s: %s", defs[t].name, err);
+            goto cleanup;
+        }
+    }
+
+    chan_reset();
+    s_instance_count = 0;
+    metrics_init();
+    metrics_phase_begin("chan");
+
+    int max_pairs  = cfg->max_instances / 2;
+    int peak_pairs = 0;
+
+    for (int p = 1; p <= max_pairs; p++) {
+        uint32_t ring = (uint32_t)((p - 1) % CHAN_COUNT);
+        bool     ok   = true;
+
+        for (int t = 0; t < 2 && ok; t++) {
+            if (!spawn_instance(s_instance_count, cfg,
+                                (void *)modules[t], defs[t].name, ring)) {
+                printf("  SPAWN_FAIL  task=%s\n", defs[t].name);
+                ok = false;
+            } else {
+                s_instance_count++;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+
+        k_sleep(K_MSEC(cfg->scale_delay_ms));
+
+        if (!s_instances[s_instance_count - 2].alive ||
+            !s_instances[s_instance_count - 1].alive) {
+            printf("  TASK_DIED  pair=%d\n", p);
+            s_instance_count -= 2;
+            break;
+        }
+
+        uint64_t rx0 = chan_total_received();
+        int64_t  t0  = k_uptime_get();
+
+        k_sleep(K_MSEC(cfg->measure_delay_ms));
+
+        uint32_t window_ms = (uint32_t)(k_uptime_get() - t0);
+        uint64_t delta     = chan_total_received() - rx0;
+        uint32_t rate      = (window_ms > 0) ?
+                             (uint32_t)((delta * 1000U) / window_ms) : 0;
+
+        metrics_t m;
+
+        metrics_sample(&m);
+        printf("pairs=%-2d  msgs=%-8u  rate=%-7umsg/s  heap=%4uKB  cpu=%3u%%\n",
+               p, (unsigned)delta, (unsigned)rate,
+               (unsigned)(m.heap_free / 1024), (unsigned)m.cpu_percent);
+
+        peak_pairs = p;
+    }
+
+    k_sleep(K_MSEC(cfg->measure_delay_ms));
+    printf("\n--- Peak: %d producer/consumer pairs ---\n", peak_pairs);
+    print_instance_stats();
+
+    stop_all_instances();
+    metrics_phase_end();
+
+cleanup:
+    for (int t = 0; t < 2; t++) {
+        if (modules[t]) {
+            wasm_runtime_unload(modules[t]);
+        }
+        if (bufs[t]) {
+            free(bufs[t]);
+        }
+    }
+}
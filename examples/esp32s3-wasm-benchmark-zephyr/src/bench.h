@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <zephyr/kernel.h>
 
+#include "metrics.h"
+
 typedef enum {
     WORKLOAD_CPU = 0,
     WORKLOAD_MEM,
@@ -18,8 +20,12 @@ typedef struct {
     volatile bool    alive;
     uint32_t         iterations;
     uint32_t         errors;
+    uint32_t         instantiate_failures;
     uint32_t         last_latency_us;
+    latency_hist_t   hist;
     uint32_t         wasm_stack_bytes;
+    uint32_t         arg0;
+    int              pinned_core;
 
     struct k_thread  thread_data;
     k_tid_t          tid;
@@ -35,12 +41,19 @@ typedef enum {
     MODE_SHARED_MODULE = 0,
 } bench_mode_t;
 
+typedef enum {
+    PIN_NONE = 0,       /* scheduler migrates workers freely */
+    PIN_EXPLICIT,       /* every instance pinned to core_affinity */
+    PIN_ROUND_ROBIN,    /* instance i pinned to core i % num_cpus */
+} pin_mode_t;
+
 typedef struct {
     bench_mode_t     mode;
     workload_type_t  workload;
     uint32_t         wasm_stack_kb;
     uint32_t         wasm_heap_kb;
     uint32_t         task_stack_kb;
+    pin_mode_t       pin_mode;
     int              core_affinity;
     uint32_t         scale_delay_ms;
     uint32_t         measure_delay_ms;
@@ -52,3 +65,5 @@ int  bench_run(const bench_config_t *cfg);
 void bench_run_all_workloads(const bench_config_t *base_cfg);
 void bench_compare_modes(const bench_config_t *base_cfg);
 void bench_run_diverse(const bench_config_t *cfg);
+void bench_run_sweep(const bench_config_t *base_cfg);
+void bench_run_channel(const bench_config_t *cfg);
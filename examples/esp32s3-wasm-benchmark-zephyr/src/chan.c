@@ -0,0 +1,91 @@
+#include "chan.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include "wasm_export.h"
+
+typedef struct {
+    uint32_t          buf[CHAN_DEPTH];
+    uint32_t          head;      /* next write slot (monotonic) */
+    uint32_t          tail;      /* next read slot (monotonic) */
+    uint32_t          sent;
+    uint32_t          received;
+    struct k_spinlock lock;
+} chan_t;
+
+static chan_t s_chans[CHAN_COUNT];
+
+void chan_reset(void)
+{
+    memset(s_chans, 0, sizeof(s_chans));
+}
+
+static int32_t chan_send_native(wasm_exec_env_t exec_env, int32_t chan,
+                                int32_t value)
+{
+    ARG_UNUSED(exec_env);
+
+    if (chan < 0 || chan >= CHAN_COUNT) {
+        return 0;
+    }
+
+    chan_t          *c   = &s_chans[chan];
+    int32_t          ok  = 0;
+    k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+    if (c->head - c->tail < CHAN_DEPTH) {
+        c->buf[c->head % CHAN_DEPTH] = (uint32_t)value;
+        c->head++;
+        c->sent++;
+        ok = 1;
+    }
+    k_spin_unlock(&c->lock, key);
+
+    return ok;
+}
+
+static int32_t chan_recv_native(wasm_exec_env_t exec_env, int32_t chan)
+{
+    ARG_UNUSED(exec_env);
+
+    if (chan < 0 || chan >= CHAN_COUNT) {
+        return -1;
+    }
+
+    chan_t          *c     = &s_chans[chan];
+    int32_t          value = -1;
+    k_spinlock_key_t key   = k_spin_lock(&c->lock);
+
+    if (c->head != c->tail) {
+        value = (int32_t)c->buf[c->tail % CHAN_DEPTH];
+        c->tail++;
+        c->received++;
+    }
+    k_spin_unlock(&c->lock, key);
+
+    return value;
+}
+
+static NativeSymbol s_chan_symbols[] = {
+    { "chan_send", chan_send_native, "(ii)i", NULL },
+    { "chan_recv", chan_recv_native, "(i)i",  NULL },
+};
+
+bool chan_register_natives(void)
+{
+    return wasm_runtime_register_natives(
+        "env", s_chan_symbols,
+        sizeof(s_chan_symbols) / sizeof(s_chan_symbols[0]));
+}
+
+uint64_t chan_total_received(void)
+{
+    uint64_t sum = 0;
+
+    for (int i = 0; i < CHAN_COUNT; i++) {
+        sum += s_chans[i].received;
+    }
+    return sum;
+}
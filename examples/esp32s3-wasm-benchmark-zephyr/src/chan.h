@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Shared-memory message channels between WASM instances. Each channel is
+ * a fixed ring of i32 values living in host memory, exposed to WASM
+ * through two registered native symbols:
+ *
+ *   chan_send(chan, value) -> 1 if queued, 0 if the ring is full
+ *   chan_recv(chan)        -> the value, or -1 if the ring is empty
+ *
+ * This is the zero-hop data path between a producer and a consumer
+ * instance — no broker round-trip, no copies beyond the ring slot.
+ */
+#define CHAN_COUNT 4
+#define CHAN_DEPTH 64
+
+void     chan_reset(void);
+bool     chan_register_natives(void);
+uint64_t chan_total_received(void);
@@ -88,6 +88,7 @@ int main(void)
     printf("\n--- Experiment: Core Pinning ---\n");
     printf("Run 1: All instances on Core 0\n");
     cfg.workload      = WORKLOAD_CPU;
+    cfg.pin_mode      = PIN_EXPLICIT;
     cfg.core_affinity = 0;
     int core0_max = bench_run(&cfg);
     k_sleep(K_MSEC(2000));
@@ -97,8 +98,14 @@ int main(void)
     int core1_max = bench_run(&cfg);
     k_sleep(K_MSEC(2000));
 
-    printf("\nRun 3: Distributed (no affinity)\n");
+    printf("\nRun 3: Round-robin across cores\n");
+    cfg.pin_mode      = PIN_ROUND_ROBIN;
     cfg.core_affinity = -1;
+    int rr_max = bench_run(&cfg);
+    k_sleep(K_MSEC(2000));
+
+    printf("\nRun 4: Floating (no affinity)\n");
+    cfg.pin_mode      = PIN_NONE;
     int dist_max = bench_run(&cfg);
 
     printf("\n╔══════════════════════════════╗\n");
@@ -106,7 +113,8 @@ int main(void)
     printf("╠══════════════════════════════╣\n");
     printf("║  Core 0 only  : %-3d instances║\n", core0_max);
     printf("║  Core 1 only  : %-3d instances║\n", core1_max);
-    printf("║  Distributed  : %-3d instances║\n", dist_max);
+    printf("║  Round-robin  : %-3d instances║\n", rr_max);
+    printf("║  Floating     : %-3d instances║\n", dist_max);
     printf("╚══════════════════════════════╝\n");
 
 #elif EXPERIMENT == 5
@@ -114,6 +122,12 @@ int main(void)
 
 #elif EXPERIMENT == 6
     bench_run_diverse(&cfg);
+
+#elif EXPERIMENT == 7
+    bench_run_sweep(&cfg);
+
+#elif EXPERIMENT == 8
+    bench_run_channel(&cfg);
 #endif
 
     printf("\nBenchmark complete. Halting.\n");
@@ -1,6 +1,7 @@
 #include "metrics.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <zephyr/kernel.h>
@@ -35,9 +36,156 @@ static uint32_t heap_min_free_bytes(void)
     return 0;
 }
 
+/* Fragmentation proxy: binary-search the largest single malloc that
+ * succeeds right now, up to cap bytes (0 = unlimited). ~20 transient
+ * allocations per call, so this runs from samplers and step boundaries,
+ * never from worker loops.
+ */
+static uint32_t largest_free_block_capped(uint32_t cap)
+{
+    uint32_t lo = 0;
+    uint32_t hi = heap_free_bytes();
+
+    if (cap > 0 && hi > cap) {
+        hi = cap;
+    }
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        void *p = malloc(mid);
+
+        if (p) {
+            free(p);
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+static uint32_t largest_free_block(void)
+{
+    return largest_free_block_capped(0);
+}
+
+static struct {
+    const char *name;
+    volatile bool active;
+    uint32_t    samples;
+    uint32_t    heap_free_min;
+    uint32_t    largest_min;
+    uint32_t    alloc_peak;
+} s_phase;
+
+#define PHASE_SAMPLE_INTERVAL_MS 500
+
+/* Mid-phase probes are capped: briefly claiming the entire free heap
+ * every 500 ms makes concurrent instantiations fail and distorts the
+ * numbers the phase is trying to measure. A probe that reaches the cap
+ * reports the cap (saturated); uncapped probes stay at quiesced phase
+ * boundaries via metrics_sample().
+ */
+#define PHASE_PROBE_CAP (32 * 1024)
+
+/* The probe mallocs, so sampling runs in a work item, not the ISR */
+static void phase_sample_work_handler(struct k_work *work)
+{
+    struct sys_memory_stats stats;
+
+    ARG_UNUSED(work);
+
+    if (!s_phase.active || malloc_runtime_stats_get(&stats) != 0) {
+        return;
+    }
+
+    uint32_t largest = largest_free_block_capped(PHASE_PROBE_CAP);
+
+    if ((uint32_t)stats.free_bytes < s_phase.heap_free_min) {
+        s_phase.heap_free_min = (uint32_t)stats.free_bytes;
+    }
+    if (largest < s_phase.largest_min) {
+        s_phase.largest_min = largest;
+    }
+    if ((uint32_t)stats.allocated_bytes > s_phase.alloc_peak) {
+        s_phase.alloc_peak = (uint32_t)stats.allocated_bytes;
+    }
+    s_phase.samples++;
+}
+
+K_WORK_DEFINE(s_phase_work, phase_sample_work_handler);
+
+static void phase_timer_expire(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+    k_work_submit(&s_phase_work);
+}
+
+K_TIMER_DEFINE(s_phase_timer, phase_timer_expire, NULL);
+
+void metrics_phase_begin(const char *name)
+{
+    s_phase.name          = name;
+    s_phase.samples       = 0;
+    s_phase.heap_free_min = UINT32_MAX;
+    s_phase.largest_min   = UINT32_MAX;
+    s_phase.alloc_peak    = 0;
+    s_phase.active        = true;
+
+    k_timer_start(&s_phase_timer, K_MSEC(PHASE_SAMPLE_INTERVAL_MS),
+                  K_MSEC(PHASE_SAMPLE_INTERVAL_MS));
+}
+
+void metrics_phase_end(void)
+{
+    k_timer_stop(&s_phase_timer);
+    s_phase.active = false;
+
+    if (s_phase.samples == 0) {
+        printf("[phase %s] no samples\n", s_phase.name ? s_phase.name : "?");
+        return;
+    }
+
+    uint32_t frag      = 0;
+    bool     saturated = (s_phase.largest_min >= PHASE_PROBE_CAP);
+
+    if (s_phase.heap_free_min > 0 &&
+        s_phase.largest_min <= s_phase.heap_free_min) {
+        frag = 100 - (uint32_t)(((uint64_t)s_phase.largest_min * 100) /
+                                s_phase.heap_free_min);
+    }
+
+    /* A saturated probe only proves a block >= the cap existed, so the
+     * derived fragmentation figure is an upper bound.
+     */
+    printf("[phase %s] samples=%u  heap_free_min=%uKB  largest_blk_min%s%uKB"
+           "  alloc_peak=%uKB  frag=%s%u%%\n",
+           s_phase.name ? s_phase.name : "?",
+           (unsigned)s_phase.samples,
+           (unsigned)(s_phase.heap_free_min / 1024),
+           saturated ? ">=" : "=",
+           (unsigned)(s_phase.largest_min / 1024),
+           (unsigned)(s_phase.alloc_peak / 1024),
+           saturated ? "<=" : "",
+           (unsigned)frag);
+}
+
 static uint64_t s_prev_exec_cycles;
 static uint64_t s_prev_busy_cycles;
 
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+static uint64_t s_prev_core_exec[METRICS_MAX_CORES];
+static uint64_t s_prev_core_busy[METRICS_MAX_CORES];
+#endif
+
+static uint32_t load_percent(uint64_t exec_delta, uint64_t busy_delta)
+{
+    if (exec_delta > 0 && busy_delta <= exec_delta) {
+        return (uint32_t)((busy_delta * 100ULL) / exec_delta);
+    }
+    return 0;
+}
+
 void metrics_init(void)
 {
     k_thread_runtime_stats_t stats;
@@ -45,13 +193,23 @@ void metrics_init(void)
     k_thread_runtime_stats_all_get(&stats);
     s_prev_exec_cycles = stats.execution_cycles;
     s_prev_busy_cycles = stats.total_cycles;
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+    for (int cpu = 0; cpu < arch_num_cpus() && cpu < METRICS_MAX_CORES; cpu++) {
+        if (k_thread_runtime_stats_cpu_get(cpu, &stats) == 0) {
+            s_prev_core_exec[cpu] = stats.execution_cycles;
+            s_prev_core_busy[cpu] = stats.total_cycles;
+        }
+    }
+#endif
 }
 
 void metrics_sample(metrics_t *out)
 {
-    out->heap_free = heap_free_bytes();
-    out->heap_min  = heap_min_free_bytes();
-    out->uptime_ms = (uint32_t)k_uptime_get();
+    out->heap_free          = heap_free_bytes();
+    out->heap_min           = heap_min_free_bytes();
+    out->heap_largest_block = largest_free_block();
+    out->uptime_ms          = (uint32_t)k_uptime_get();
 
     k_thread_runtime_stats_t stats;
 
@@ -60,22 +218,101 @@ void metrics_sample(metrics_t *out)
     uint64_t exec_delta = stats.execution_cycles - s_prev_exec_cycles;
     uint64_t busy_delta = stats.total_cycles     - s_prev_busy_cycles;
 
-    if (exec_delta > 0 && busy_delta <= exec_delta) {
-        out->cpu_percent = (uint32_t)((busy_delta * 100ULL) / exec_delta);
-    } else {
-        out->cpu_percent = 0;
-    }
+    out->cpu_percent = load_percent(exec_delta, busy_delta);
 
     s_prev_exec_cycles = stats.execution_cycles;
     s_prev_busy_cycles = stats.total_cycles;
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+    out->num_cores = 0;
+    for (int cpu = 0; cpu < arch_num_cpus() && cpu < METRICS_MAX_CORES; cpu++) {
+        if (k_thread_runtime_stats_cpu_get(cpu, &stats) != 0) {
+            break;
+        }
+
+        uint64_t core_exec = stats.execution_cycles - s_prev_core_exec[cpu];
+        uint64_t core_busy = stats.total_cycles     - s_prev_core_busy[cpu];
+
+        out->core_percent[cpu] = load_percent(core_exec, core_busy);
+        s_prev_core_exec[cpu]  = stats.execution_cycles;
+        s_prev_core_busy[cpu]  = stats.total_cycles;
+        out->num_cores++;
+    }
+    if (out->num_cores == 0) {
+        out->num_cores       = 1;
+        out->core_percent[0] = out->cpu_percent;
+    }
+#else
+    out->num_cores       = 1;
+    out->core_percent[0] = out->cpu_percent;
+#endif
+}
+
+void lat_hist_reset(latency_hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void lat_hist_record(latency_hist_t *h, uint32_t us)
+{
+    int bucket = (us > 1) ? (32 - __builtin_clz(us)) - 1 : 0;
+
+    if (bucket >= LAT_HIST_BUCKETS) {
+        bucket = LAT_HIST_BUCKETS - 1;
+    }
+
+    h->counts[bucket]++;
+    h->total++;
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+}
+
+void lat_hist_merge(latency_hist_t *dst, const latency_hist_t *src)
+{
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    if (src->max_us > dst->max_us) {
+        dst->max_us = src->max_us;
+    }
+}
+
+uint32_t lat_hist_percentile(const latency_hist_t *h, uint32_t pct)
+{
+    if (h->total == 0) {
+        return 0;
+    }
+
+    uint64_t target = ((uint64_t)h->total * pct + 99) / 100;
+    uint64_t seen   = 0;
+
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= target) {
+            uint32_t edge = (i < 31) ? (2U << i) : UINT32_MAX;
+
+            return (edge < h->max_us) ? edge : h->max_us;
+        }
+    }
+    return h->max_us;
 }
 
 void metrics_print(int instances, const metrics_t *m)
 {
-    printf("instances=%-3d  heap=%4uKB  min=%4uKB  cpu=%3u%%  up=%us\n",
+    printf("instances=%-3d  heap=%4uKB  min=%4uKB  blk=%4uKB  cpu=%3u%%",
            instances,
            (unsigned)(m->heap_free / 1024),
            (unsigned)(m->heap_min  / 1024),
-           (unsigned)m->cpu_percent,
-           (unsigned)(m->uptime_ms / 1000));
+           (unsigned)(m->heap_largest_block / 1024),
+           (unsigned)m->cpu_percent);
+
+    if (m->num_cores > 1) {
+        for (uint32_t cpu = 0; cpu < m->num_cores; cpu++) {
+            printf("  c%u=%3u%%", (unsigned)cpu,
+                   (unsigned)m->core_percent[cpu]);
+        }
+    }
+    printf("  up=%us\n", (unsigned)(m->uptime_ms / 1000));
 }
@@ -2,13 +2,50 @@
 
 #include <stdint.h>
 
+/* Per-core load needs CONFIG_SMP + CONFIG_SCHED_THREAD_USAGE_ALL; on
+ * single-core builds num_cores is 1 and core_percent[0] == cpu_percent.
+ */
+#define METRICS_MAX_CORES 2
+
 typedef struct {
     uint32_t heap_free;
     uint32_t heap_min;
+    uint32_t heap_largest_block;
     uint32_t cpu_percent;
+    uint32_t num_cores;
+    uint32_t core_percent[METRICS_MAX_CORES];
     uint32_t uptime_ms;
 } metrics_t;
 
+/*
+ * Log-bucketed latency histogram: bucket i counts samples in
+ * [2^i, 2^(i+1)) microseconds, so 24 buckets cover 1us..16s in fixed
+ * memory. Percentiles are read off the bucket upper edges (HDR-style,
+ * <=2x relative error), which is plenty for spotting tail blowups.
+ */
+#define LAT_HIST_BUCKETS 24
+
+typedef struct {
+    uint32_t counts[LAT_HIST_BUCKETS];
+    uint32_t total;
+    uint32_t max_us;
+} latency_hist_t;
+
+void     lat_hist_reset(latency_hist_t *h);
+void     lat_hist_record(latency_hist_t *h, uint32_t us);
+void     lat_hist_merge(latency_hist_t *dst, const latency_hist_t *src);
+uint32_t lat_hist_percentile(const latency_hist_t *h, uint32_t pct);
+
 void metrics_init(void);
 void metrics_sample(metrics_t *out);
 void metrics_print(int instances, const metrics_t *m);
+
+/*
+ * Phase telemetry: between begin and end a timer samples heap stats and
+ * the largest allocatable block (fragmentation proxy, capped at 32 KB so
+ * the probe never starves running workers) every 500 ms, and end prints
+ * the worst readings seen. Wrap each benchmark phase in a pair so long
+ * soaks show allocator decay, not just endpoint numbers.
+ */
+void metrics_phase_begin(const char *name);
+void metrics_phase_end(void);
@@ -55,3 +55,24 @@ static const uint8_t wasm_popcount[] = {
     0x41, 0x00, 0x0b,
 };
 static const uint32_t wasm_popcount_len = sizeof(wasm_popcount);
+
+static const uint8_t wasm_chan_producer[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60, 0x02, 0x7f, 0x7f, 0x01,
+    0x7f, 0x02, 0x11, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x09, 0x63, 0x68, 0x61, 0x6e, 0x5f, 0x73, 0x65,
+    0x6e, 0x64, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04, 0x6d, 0x61, 0x69, 0x6e,
+    0x00, 0x01, 0x0a, 0x2a, 0x01, 0x28, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x02, 0x41,
+    0xe8, 0x07, 0x4f, 0x0d, 0x01, 0x20, 0x03, 0x20, 0x00, 0x20, 0x02, 0x10, 0x00, 0x6a, 0x21, 0x03,
+    0x20, 0x02, 0x41, 0x01, 0x6a, 0x21, 0x02, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x03, 0x0b,
+};
+static const uint32_t wasm_chan_producer_len = sizeof(wasm_chan_producer);
+
+static const uint8_t wasm_chan_consumer[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x11, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x09, 0x63, 0x68,
+    0x61, 0x6e, 0x5f, 0x72, 0x65, 0x63, 0x76, 0x00, 0x00, 0x03, 0x02, 0x01, 0x01, 0x07, 0x08, 0x01,
+    0x04, 0x6d, 0x61, 0x69, 0x6e, 0x00, 0x01, 0x0a, 0x2b, 0x01, 0x29, 0x01, 0x02, 0x7f, 0x02, 0x40,
+    0x03, 0x40, 0x20, 0x02, 0x41, 0xe8, 0x07, 0x4f, 0x0d, 0x01, 0x20, 0x03, 0x20, 0x00, 0x10, 0x00,
+    0x41, 0x7f, 0x47, 0x6a, 0x21, 0x03, 0x20, 0x02, 0x41, 0x01, 0x6a, 0x21, 0x02, 0x0c, 0x00, 0x0b,
+    0x0b, 0x20, 0x03, 0x0b,
+};
+static const uint32_t wasm_chan_consumer_len = sizeof(wasm_chan_consumer);
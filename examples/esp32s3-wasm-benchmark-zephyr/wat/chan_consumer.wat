@@ -0,0 +1,18 @@
+;; Channel consumer: attempts 1000 receives per call from the host ring
+;; selected by arg0 and returns how many carried a value (-1 marks an
+;; empty poll).
+(module
+  (import "env" "chan_recv" (func $chan_recv (param i32) (result i32)))
+  (func $main (param i32 i32) (result i32)
+    (local $i i32)
+    (local $got i32)
+    (block $break
+      (loop $loop
+        (br_if $break (i32.ge_u (local.get $i) (i32.const 1000)))
+        (local.set $got
+          (i32.add (local.get $got)
+                   (i32.ne (call $chan_recv (local.get 0)) (i32.const -1))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)))
+    (local.get $got))
+  (export "main" (func $main)))
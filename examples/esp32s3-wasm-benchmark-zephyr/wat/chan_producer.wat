@@ -0,0 +1,18 @@
+;; Channel producer: pushes 1000 values per call into the host ring
+;; selected by arg0. Returns how many sends actually landed, so the
+;; return value shows backpressure when the consumer falls behind.
+(module
+  (import "env" "chan_send" (func $chan_send (param i32 i32) (result i32)))
+  (func $main (param i32 i32) (result i32)
+    (local $i i32)
+    (local $sent i32)
+    (block $break
+      (loop $loop
+        (br_if $break (i32.ge_u (local.get $i) (i32.const 1000)))
+        (local.set $sent
+          (i32.add (local.get $sent)
+                   (call $chan_send (local.get 0) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)))
+    (local.get $sent))
+  (export "main" (func $main)))